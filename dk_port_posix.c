@@ -0,0 +1,1175 @@
+/*
+ * dk_port_posix.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ */
+
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dk_port_posix.h"
+
+#if defined( configUSE_PORT_ARENA ) && ( configUSE_PORT_ARENA == 1 )
+
+/* Blocks this size or larger get a mapping of their own. */
+#ifndef portARENA_MMAP_THRESHOLD
+    #define portARENA_MMAP_THRESHOLD    ( ( size_t ) 128U * 1024U )
+#endif
+
+#define portARENA_HUGE_PAGE_SIZE        ( ( size_t ) 2U * 1024U * 1024U )
+#define portARENA_MAX_NODES             1024
+
+/* From <numaif.h>, which needs libnuma headers. */
+#ifndef MPOL_PREFERRED
+    #define MPOL_PREFERRED    1
+#endif
+#ifndef MPOL_BIND
+    #define MPOL_BIND         2
+#endif
+
+/* Precedes every block, keeps the returned pointer 16-byte aligned. */
+typedef struct xARENA_HEADER
+{
+    size_t xMappedLength; /*<< 0 for blocks that came from malloc(). */
+    size_t xReserved;
+} ArenaHeader_t;
+
+static int iArenaNode = -1;
+static UBaseType_t uxArenaFlags;
+
+static void prvArenaApplyPolicy( void * pv,
+                                 size_t xLength )
+{
+    unsigned long ulNodeMask[ portARENA_MAX_NODES / ( 8U * sizeof( unsigned long ) ) ] = { 0 };
+
+    /* Both are best effort: a kernel without NUMA or THP support still gets
+     * usable memory. */
+    if( ( iArenaNode >= 0 ) && ( iArenaNode < portARENA_MAX_NODES ) ) {
+        ulNodeMask[ ( size_t ) iArenaNode / ( 8U * sizeof( unsigned long ) ) ] |= 1UL << ( ( size_t ) iArenaNode % ( 8U * sizeof( unsigned long ) ) );
+        ( void ) syscall( SYS_mbind, pv, xLength,
+                          ( ( uxArenaFlags & portARENA_STRICT ) != 0U ) ? MPOL_BIND : MPOL_PREFERRED,
+                          ulNodeMask, ( unsigned long ) portARENA_MAX_NODES + 1UL, 0U );
+    }
+
+    #ifdef MADV_HUGEPAGE
+        if( ( uxArenaFlags & portARENA_THP ) != 0U ) {
+            ( void ) madvise( pv, xLength, MADV_HUGEPAGE );
+        }
+    #endif
+}
+
+void vPortArenaConfigure( int iNode,
+                          UBaseType_t uxFlags )
+{
+    iArenaNode = iNode;
+    uxArenaFlags = uxFlags;
+}
+
+void * pvPortArenaMalloc( size_t xSize )
+{
+    const size_t xPageSize = ( size_t ) sysconf( _SC_PAGESIZE );
+    ArenaHeader_t * pxHeader;
+    size_t xLength;
+    void * pvMap = MAP_FAILED;
+
+    if( xSize > ( ( size_t ) -1 ) - portARENA_HUGE_PAGE_SIZE ) {
+        return NULL;
+    }
+
+    if( ( xSize + sizeof( ArenaHeader_t ) ) < portARENA_MMAP_THRESHOLD ) {
+        pxHeader = ( ArenaHeader_t * ) malloc( xSize + sizeof( ArenaHeader_t ) );
+
+        if( pxHeader == NULL ) {
+            return NULL;
+        }
+
+        pxHeader->xMappedLength = 0U;
+        return pxHeader + 1;
+    }
+
+    #ifdef MAP_HUGETLB
+        if( ( uxArenaFlags & portARENA_HUGETLB ) != 0U ) {
+            xLength = ( xSize + sizeof( ArenaHeader_t ) + portARENA_HUGE_PAGE_SIZE - 1U ) & ~( portARENA_HUGE_PAGE_SIZE - 1U );
+            pvMap = mmap( NULL, xLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+        }
+    #endif
+
+    if( pvMap == MAP_FAILED ) {
+        /* No huge pages reserved, or none asked for. */
+        xLength = ( xSize + sizeof( ArenaHeader_t ) + xPageSize - 1U ) & ~( xPageSize - 1U );
+        pvMap = mmap( NULL, xLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+        if( pvMap == MAP_FAILED ) {
+            return NULL;
+        }
+    }
+
+    /* Nothing has been touched yet, so every page is placed by the policy. */
+    prvArenaApplyPolicy( pvMap, xLength );
+
+    pxHeader = ( ArenaHeader_t * ) pvMap;
+    pxHeader->xMappedLength = xLength;
+
+    return pxHeader + 1;
+}
+
+void vPortArenaFree( void * pv )
+{
+    ArenaHeader_t * pxHeader;
+
+    if( pv == NULL ) {
+        return;
+    }
+
+    pxHeader = ( ( ArenaHeader_t * ) pv ) - 1;
+
+    if( pxHeader->xMappedLength != 0U ) {
+        ( void ) munmap( pxHeader, pxHeader->xMappedLength );
+    }
+    else {
+        free( pxHeader );
+    }
+}
+
+void vPortArenaPlace( void * pv,
+                      size_t xSize )
+{
+    const uintptr_t uxPageMask = ( uintptr_t ) sysconf( _SC_PAGESIZE ) - 1U;
+    const uintptr_t uxStart = ( uintptr_t ) pv & ~uxPageMask;
+    const uintptr_t uxEnd = ( ( uintptr_t ) pv + xSize + uxPageMask ) & ~uxPageMask;
+
+    /* The policy covers whole pages, which may include neighbouring static
+     * data; that only affects where those pages are placed. */
+    prvArenaApplyPolicy( ( void * ) uxStart, ( size_t ) ( uxEnd - uxStart ) );
+}
+
+#endif /* configUSE_PORT_ARENA */
+
+#if defined( configUSE_PORT_RUN_LOOP ) && ( configUSE_PORT_RUN_LOOP == 1 )
+
+#define portRUN_NS_PER_TICK       ( ( int64_t ) portRUN_TICK_PERIOD_US * 1000 )
+#define portRUN_MAX_WAKE_TICKS    ( ( TickType_t ) 0x7fffffffUL )
+
+static int64_t llRunEpoch = -1;
+
+/* The loop currently in dk_timer_run(), for vPortTimerRunNotify(). */
+static TimerRunService_t * volatile pxRunningService;
+
+static int64_t prvRunClockNs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( ( int64_t ) xNow.tv_sec * 1000000000 ) + xNow.tv_nsec;
+}
+
+uint32_t ulPortRunGetTickCount( void )
+{
+    int64_t llEpoch = __atomic_load_n( &llRunEpoch, __ATOMIC_RELAXED );
+    const int64_t llNow = prvRunClockNs();
+
+    if( llEpoch < 0 ) {
+        /* First call, several threads may race to set the epoch. */
+        int64_t llExpected = -1;
+
+        ( void ) __atomic_compare_exchange_n( &llRunEpoch, &llExpected, llNow, pdFALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+        llEpoch = __atomic_load_n( &llRunEpoch, __ATOMIC_RELAXED );
+    }
+
+    return ( uint32_t ) ( ( llNow - llEpoch ) / portRUN_NS_PER_TICK );
+}
+
+void vTimerRunServiceInit( TimerRunService_t * pxService )
+{
+    ( void ) memset( pxService, 0, sizeof( *pxService ) );
+}
+
+void dk_timer_run( TimerRunService_t * pxService )
+{
+    struct timespec xDeadline;
+    uint32_t ulSignal;
+    uint32_t ulTick;
+    TickType_t xIdle;
+    int64_t llWake;
+
+    __atomic_store_n( &pxRunningService, pxService, __ATOMIC_SEQ_CST );
+
+    while( __atomic_load_n( &( pxService->ulStop ), __ATOMIC_ACQUIRE ) == 0U ) {
+        dk_timer_task();
+
+        /* Sample the signal before the timers.  A command posted after this
+         * point bumps the signal, so the futex wait below returns at once
+         * unless it is already asleep, in which case ulSleeping and
+         * ulWakeTick are published and the notification wakes it if needed. */
+        ulSignal = __atomic_load_n( &( pxService->ulSignal ), __ATOMIC_SEQ_CST );
+        ulTick = ulPortRunGetTickCount();
+        xIdle = xTimerGetExpectedIdleTime();
+
+        if( ( xIdle != 0U ) && ( __atomic_load_n( &( pxService->ulStop ), __ATOMIC_ACQUIRE ) == 0U ) ) {
+            /* Clamped so vPortTimerRunNotify() can compare against it with
+             * wrapping arithmetic. */
+            __atomic_store_n( &( pxService->ulWakeTick ), ulTick + ( ( xIdle > portRUN_MAX_WAKE_TICKS ) ? portRUN_MAX_WAKE_TICKS : xIdle ), __ATOMIC_RELAXED );
+            __atomic_store_n( &( pxService->ulSleeping ), 1U, __ATOMIC_SEQ_CST );
+
+            if( xIdle == portMAX_DELAY ) {
+                ( void ) syscall( SYS_futex, &( pxService->ulSignal ), FUTEX_WAIT_PRIVATE, ulSignal, NULL, NULL, 0 );
+            }
+            else {
+                /* Wake at the start of the tick the timer expires in. */
+                llWake = llRunEpoch + ( ( ( int64_t ) ulTick + xIdle ) * portRUN_NS_PER_TICK );
+                xDeadline.tv_sec = ( time_t ) ( llWake / 1000000000 );
+                xDeadline.tv_nsec = ( long ) ( llWake % 1000000000 );
+
+                /* FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC
+                 * deadline, so an interrupted wait does not drift. */
+                ( void ) syscall( SYS_futex, &( pxService->ulSignal ), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, ulSignal, &xDeadline, NULL, FUTEX_BITSET_MATCH_ANY );
+            }
+
+            __atomic_store_n( &( pxService->ulSleeping ), 0U, __ATOMIC_RELAXED );
+        }
+    }
+
+    __atomic_store_n( &pxRunningService, NULL, __ATOMIC_SEQ_CST );
+}
+
+void vPortTimerRunNotify( TickType_t xDueTime )
+{
+    TimerRunService_t * const pxService = __atomic_load_n( &pxRunningService, __ATOMIC_SEQ_CST );
+
+    if( pxService == NULL ) {
+        return;
+    }
+
+    ( void ) __atomic_fetch_add( &( pxService->ulSignal ), 1U, __ATOMIC_SEQ_CST );
+
+    /* Most commands arm timers that expire after the current deadline, they
+     * are picked up when the loop wakes anyway. */
+    if( ( __atomic_load_n( &( pxService->ulSleeping ), __ATOMIC_SEQ_CST ) != 0U ) &&
+        ( ( int32_t ) ( __atomic_load_n( &( pxService->ulWakeTick ), __ATOMIC_SEQ_CST ) - xDueTime ) > 0 ) ) {
+        ( void ) syscall( SYS_futex, &( pxService->ulSignal ), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+    }
+}
+
+void vTimerRunStop( TimerRunService_t * pxService )
+{
+    __atomic_store_n( &( pxService->ulStop ), 1U, __ATOMIC_RELEASE );
+    ( void ) __atomic_fetch_add( &( pxService->ulSignal ), 1U, __ATOMIC_SEQ_CST );
+    ( void ) syscall( SYS_futex, &( pxService->ulSignal ), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+}
+
+static void * prvRunThread( void * pvParameter )
+{
+    TimerRunService_t * const pxService = ( TimerRunService_t * ) pvParameter;
+    volatile uint8_t ucStack[ portRUN_THREAD_PREFAULT_STACK ];
+    size_t x;
+
+    /* Touch one byte per page, deepest first, so the stack the loop and the
+     * callbacks run on is mapped before the first expiry. */
+    for( x = sizeof( ucStack ); x > 0U; x -= ( x > 4096U ) ? 4096U : x ) {
+        ucStack[ x - 1U ] = 0U;
+    }
+
+    dk_timer_run( pxService );
+    return NULL;
+}
+
+BaseType_t xTimerRunThreadStart( TimerRunService_t * pxService,
+                                 const TimerRunThreadConfig_t * pxConfig )
+{
+    pthread_attr_t xAttr;
+    cpu_set_t xCpus;
+    struct sched_param xParam;
+    const BaseType_t xLock = ( ( pxConfig->uxFlags & portRUN_THREAD_LOCK_MEMORY ) != 0U ) ? pdTRUE : pdFALSE;
+    int iError = 0;
+
+    /* CPU_SET() is undefined past the end of the set. */
+    if( pxConfig->iCpu >= CPU_SETSIZE ) {
+        return pdFALSE;
+    }
+
+    if( pthread_attr_init( &xAttr ) != 0 ) {
+        return pdFALSE;
+    }
+
+    /* Applied at creation rather than by the thread itself, so a setting
+     * that is refused fails the start instead of leaving a thread running
+     * with the wrong one. */
+    if( pxConfig->iCpu >= 0 ) {
+        CPU_ZERO( &xCpus );
+        CPU_SET( pxConfig->iCpu, &xCpus );
+        iError = pthread_attr_setaffinity_np( &xAttr, sizeof( xCpus ), &xCpus );
+    }
+
+    if( ( iError == 0 ) && ( pxConfig->iPriority > 0 ) ) {
+        xParam.sched_priority = pxConfig->iPriority;
+        iError = pthread_attr_setinheritsched( &xAttr, PTHREAD_EXPLICIT_SCHED );
+
+        if( iError == 0 ) {
+            iError = pthread_attr_setschedpolicy( &xAttr, SCHED_FIFO );
+        }
+
+        if( iError == 0 ) {
+            iError = pthread_attr_setschedparam( &xAttr, &xParam );
+        }
+    }
+
+    /* Locked just before the thread is created, so its stack is locked as
+     * it is mapped, and unlocked again if the thread cannot be started. */
+    if( ( iError == 0 ) && ( xLock != pdFALSE ) && ( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 ) ) {
+        iError = errno;
+    }
+
+    if( iError == 0 ) {
+        iError = pthread_create( &( pxService->xThread ), &xAttr, prvRunThread, pxService );
+
+        if( ( iError != 0 ) && ( xLock != pdFALSE ) ) {
+            ( void ) munlockall();
+        }
+    }
+
+    ( void ) pthread_attr_destroy( &xAttr );
+    return ( iError == 0 ) ? pdTRUE : pdFALSE;
+}
+
+void vTimerRunThreadStop( TimerRunService_t * pxService )
+{
+    vTimerRunStop( pxService );
+    ( void ) pthread_join( pxService->xThread, NULL );
+}
+
+#endif /* configUSE_PORT_RUN_LOOP */
+
+#if ( configUSE_TIMER_SNAPSHOT == 1 )
+
+#define portSNAPSHOT_PATH_MAX    4096
+
+BaseType_t xTimerSnapshotSaveFile( const char * pcPath,
+                                   uint64_t ullAnchor,
+                                   TimerSnapshotKeyFunction_t pxGetKey )
+{
+    char cTempPath[ portSNAPSHOT_PATH_MAX ];
+    size_t xMapSize = xTimerSnapshotSize();
+    size_t xWritten = 0;
+    void * pvMap;
+    int iFd;
+
+    if( snprintf( cTempPath, sizeof( cTempPath ), "%s.tmp", pcPath ) >= ( int ) sizeof( cTempPath ) ) {
+        return pdFALSE;
+    }
+
+    iFd = open( cTempPath, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+
+    if( iFd < 0 ) {
+        return pdFALSE;
+    }
+
+    if( ftruncate( iFd, ( off_t ) xMapSize ) == 0 ) {
+        pvMap = mmap( NULL, xMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0 );
+
+        if( pvMap != MAP_FAILED ) {
+            xWritten = xTimerSnapshotSave( pvMap, xMapSize, ullAnchor, pxGetKey );
+            ( void ) msync( pvMap, xMapSize, MS_SYNC );
+            ( void ) munmap( pvMap, xMapSize );
+        }
+    }
+
+    /* Timers the key function skipped leave unused space at the end. */
+    if( ( xWritten == 0 ) ||
+        ( ftruncate( iFd, ( off_t ) xWritten ) != 0 ) ||
+        ( fsync( iFd ) != 0 ) ) {
+        ( void ) close( iFd );
+        ( void ) unlink( cTempPath );
+        return pdFALSE;
+    }
+
+    ( void ) close( iFd );
+
+    return ( rename( cTempPath, pcPath ) == 0 ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerSnapshotLoadFile( const char * pcPath,
+                                     uint64_t ullNow,
+                                     TimerSnapshotCreateFunction_t pxCreate,
+                                     void * pvContext )
+{
+    UBaseType_t uxRestored = 0;
+    struct stat xStat;
+    void * pvMap;
+    int iFd;
+
+    iFd = open( pcPath, O_RDONLY );
+
+    if( iFd < 0 ) {
+        return 0;
+    }
+
+    if( ( fstat( iFd, &xStat ) == 0 ) && ( xStat.st_size > 0 ) ) {
+        pvMap = mmap( NULL, ( size_t ) xStat.st_size, PROT_READ, MAP_PRIVATE, iFd, 0 );
+
+        if( pvMap != MAP_FAILED ) {
+            /* The records are consumed front to back exactly once. */
+            ( void ) madvise( pvMap, ( size_t ) xStat.st_size, MADV_SEQUENTIAL );
+            uxRestored = uxTimerSnapshotLoad( pvMap, ( size_t ) xStat.st_size, ullNow, pxCreate, pvContext );
+            ( void ) munmap( pvMap, ( size_t ) xStat.st_size );
+        }
+    }
+
+    ( void ) close( iFd );
+
+    return uxRestored;
+}
+
+#endif /* configUSE_TIMER_SNAPSHOT */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+
+static int iWorkloadFd = -1;
+
+static void prvWorkloadWrite( const void * pvData,
+                              size_t xLength,
+                              void * pvContext )
+{
+    const uint8_t * pucData = ( const uint8_t * ) pvData;
+    ssize_t xWritten;
+
+    ( void ) pvContext;
+
+    while( xLength > 0U ) {
+        xWritten = write( iWorkloadFd, pucData, xLength );
+
+        if( xWritten <= 0 ) {
+            /* Leave a truncated recording rather than stall the timers. */
+            if( ( xWritten < 0 ) && ( errno == EINTR ) ) {
+                continue;
+            }
+
+            return;
+        }
+
+        pucData += xWritten;
+        xLength -= ( size_t ) xWritten;
+    }
+}
+
+BaseType_t xTimerWorkloadRecordFile( const char * pcPath )
+{
+    vTimerWorkloadRecordCloseFile();
+
+    iWorkloadFd = open( pcPath, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+    if( iWorkloadFd < 0 ) {
+        return pdFALSE;
+    }
+
+    vTimerWorkloadRecordStart( prvWorkloadWrite, NULL );
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerWorkloadRecordCloseFile( void )
+{
+    if( iWorkloadFd >= 0 ) {
+        vTimerWorkloadRecordStop();
+        ( void ) close( iWorkloadFd );
+        iWorkloadFd = -1;
+    }
+}
+
+#endif /* configUSE_TIMER_WORKLOAD_RECORD */
+
+#if defined( configUSE_PORT_SHARED_TIMERS ) && ( configUSE_PORT_SHARED_TIMERS == 1 )
+
+typedef char prvSharedCommandLengthCheck[ ( ( portSHARED_TIMER_COMMAND_LENGTH & ( portSHARED_TIMER_COMMAND_LENGTH - 1 ) ) == 0 ) ? 1 : -1 ];
+typedef char prvSharedCompletionLengthCheck[ ( ( portSHARED_TIMER_COMPLETION_LENGTH & ( portSHARED_TIMER_COMPLETION_LENGTH - 1 ) ) == 0 ) ? 1 : -1 ];
+typedef char prvSharedTimerCountCheck[ ( portSHARED_TIMER_COUNT <= ( 1UL << configTIMER_REF_INDEX_BITS ) ) ? 1 : -1 ];
+
+#define portSHARED_MAGIC              ( ( uint32_t ) 0x53534b44UL ) /* "DKSS" */
+#define portSHARED_INDEX_MASK         ( ( TimerRef_t ) ( ( 1UL << configTIMER_REF_INDEX_BITS ) - 1UL ) )
+#define portSHARED_GENERATION_MASK    ( ( uint32_t ) ( 0xffffffffUL >> configTIMER_REF_INDEX_BITS ) )
+
+#define portSHARED_COMMAND_START            ( ( uint32_t ) 1U )
+#define portSHARED_COMMAND_STOP             ( ( uint32_t ) 2U )
+#define portSHARED_COMMAND_CHANGE_PERIOD    ( ( uint32_t ) 3U )
+#define portSHARED_COMMAND_DELETE           ( ( uint32_t ) 4U )
+
+/* Same protocol as the FromISR command queue of dk_soft_timer.c: a producer
+ * claims a slot by advancing ulCommandTail with a compare-exchange and
+ * publishes it by setting the sequence to position + 1. */
+typedef struct xSHARED_TIMER_COMMAND
+{
+    uint32_t ulSequence;
+    uint32_t ulCommand;
+    TimerRef_t xRef;
+    TickType_t xValue;
+} SharedTimerCommand_t;
+
+typedef struct xSHARED_TIMER_SLOT
+{
+    uint32_t ulOwner;         /*<< 0 if free, else client index + 1.  Claimed by clients, released by the dispatcher. */
+    uint32_t ulGeneration;    /*<< Advanced by the dispatcher when the timer is deleted. */
+    TickType_t xPeriod;       /*<< Written by the owner before the timer is first started. */
+    UBaseType_t uxAutoReload;
+    uint64_t ullUserData;
+} SharedTimerSlot_t;
+
+/* The dispatcher's side of a slot.  It is kept out of the segment so that a
+ * client writing over the segment cannot reach the dispatcher's lists. */
+typedef struct xSHARED_TIMER_LOCAL
+{
+    StaticTimer_t xTimer;
+    uint32_t ulGeneration;    /*<< Published to xSlots[].ulGeneration, never read back from it. */
+    uint32_t ulCreated;
+} SharedTimerLocal_t;
+
+/* Single producer (the dispatcher), single consumer (the owning client). */
+typedef struct xSHARED_TIMER_CLIENT
+{
+    uint32_t ulPid;           /*<< 0 if the slot is free. */
+    uint32_t ulWaiting;       /*<< Set while the client sleeps on ulTail. */
+    uint32_t ulHead;
+    uint32_t ulTail;
+    uint32_t ulDropped;
+    SharedTimerExpiry_t xExpiries[ portSHARED_TIMER_COMPLETION_LENGTH ];
+} SharedTimerClient_t;
+
+typedef struct xSHARED_TIMER_SEGMENT
+{
+    uint32_t ulMagic;         /*<< Stored last, once the segment is initialised. */
+    uint32_t ulSize;
+    uint32_t ulDispatcherWaiting;
+    uint32_t ulCommandTail;
+    SharedTimerCommand_t xCommands[ portSHARED_TIMER_COMMAND_LENGTH ];
+    SharedTimerClient_t xClients[ portSHARED_TIMER_CLIENTS ];
+    SharedTimerSlot_t xSlots[ portSHARED_TIMER_COUNT ];
+} SharedTimerSegment_t;
+
+/* The per-process view of a segment. */
+typedef struct tmrSharedTimerService
+{
+    SharedTimerSegment_t * pxSegment;
+    SharedTimerLocal_t * pxLocal; /*<< portSHARED_TIMER_COUNT entries in the dispatcher, NULL in a client. */
+    uint32_t ulCommandHead;   /*<< Next command to apply, dispatcher only. */
+    uint32_t ulClient;        /*<< Client index + 1, 0 in the dispatcher. */
+    uint32_t ulNextSlot;      /*<< Where xSharedTimerCreate() starts looking. */
+    int64_t llNextReapMs;     /*<< When the dispatcher next looks for dead clients. */
+    char cName[ NAME_MAX + 1 ];
+} SharedTimerService_t;
+
+/* The dispatcher, for prvSharedTimerExpired(). */
+static SharedTimerService_t * pxDispatcher;
+
+static void prvFutexWait( uint32_t * pulWord,
+                          uint32_t ulExpected,
+                          int32_t lTimeoutMs )
+{
+    struct timespec xTimeout;
+
+    xTimeout.tv_sec = lTimeoutMs / 1000;
+    xTimeout.tv_nsec = ( long ) ( lTimeoutMs % 1000 ) * 1000000L;
+
+    /* Not FUTEX_PRIVATE_FLAG, the word is shared between processes.  An
+     * interrupted or spurious wake is handled by the callers re-checking. */
+    ( void ) syscall( SYS_futex, pulWord, FUTEX_WAIT, ulExpected, ( lTimeoutMs < 0 ) ? NULL : &xTimeout, NULL, 0 );
+}
+
+static void prvFutexWake( uint32_t * pulWord )
+{
+    ( void ) syscall( SYS_futex, pulWord, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+}
+
+static SharedTimerSlot_t * prvSharedSlotFromRef( SharedTimerService_t * pxService,
+                                                 TimerRef_t xRef )
+{
+    TimerRef_t xIndex = xRef & portSHARED_INDEX_MASK;
+    SharedTimerSlot_t * pxSlot;
+
+    if( xIndex >= ( TimerRef_t ) portSHARED_TIMER_COUNT ) {
+        return NULL;
+    }
+
+    pxSlot = &( pxService->pxSegment->xSlots[ xIndex ] );
+
+    if( ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulOwner ) ) != pxService->ulClient ) ||
+        ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulGeneration ) ) != ( xRef >> configTIMER_REF_INDEX_BITS ) ) ) {
+        return NULL;
+    }
+
+    return pxSlot;
+}
+
+static BaseType_t prvSharedSendCommand( SharedTimerService_t * pxService,
+                                        uint32_t ulCommand,
+                                        TimerRef_t xRef,
+                                        TickType_t xValue )
+{
+    SharedTimerSegment_t * pxSegment = pxService->pxSegment;
+    SharedTimerCommand_t * pxCommand;
+    uint32_t ulPosition;
+    uint32_t ulSequence;
+
+    if( prvSharedSlotFromRef( pxService, xRef ) == NULL ) {
+        return pdFALSE;
+    }
+
+    ulPosition = portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->ulCommandTail ) );
+
+    for( ; ; ) {
+        pxCommand = &( pxSegment->xCommands[ ulPosition & ( portSHARED_TIMER_COMMAND_LENGTH - 1U ) ] );
+        ulSequence = portATOMIC_LOAD_ACQUIRE_U32( &( pxCommand->ulSequence ) );
+
+        if( ulSequence == ulPosition ) {
+            if( portATOMIC_COMPARE_EXCHANGE_U32( &( pxSegment->ulCommandTail ), &ulPosition, ulPosition + 1U ) ) {
+                break;
+            }
+        }
+        else if( ( int32_t ) ( ulSequence - ulPosition ) < 0 ) {
+            /* The ring is full. */
+            return pdFALSE;
+        }
+        else {
+            ulPosition = portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->ulCommandTail ) );
+        }
+    }
+
+    pxCommand->ulCommand = ulCommand;
+    pxCommand->xRef = xRef;
+    pxCommand->xValue = xValue;
+    __atomic_store_n( &( pxCommand->ulSequence ), ulPosition + 1U, __ATOMIC_SEQ_CST );
+
+    /* Pairs with vSharedTimerServiceWait(): either the dispatcher sees the
+     * command before it sleeps, or this sees it waiting. */
+    if( __atomic_exchange_n( &( pxSegment->ulDispatcherWaiting ), 0U, __ATOMIC_SEQ_CST ) != 0U ) {
+        prvFutexWake( &( pxSegment->ulCommandTail ) );
+    }
+
+    return pdTRUE;
+}
+
+static void prvSharedTimerExpired( TimerHandle_t xTimer )
+{
+    /* The ID is the slot index, set by uxSharedTimerServiceProcess(). */
+    uint32_t ulIndex = ( uint32_t ) ( uintptr_t ) pvTimerGetTimerID( xTimer );
+    SharedTimerSlot_t * pxSlot = &( pxDispatcher->pxSegment->xSlots[ ulIndex ] );
+    uint32_t ulOwner = portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulOwner ) );
+    SharedTimerClient_t * pxClient;
+    SharedTimerExpiry_t * pxExpiry;
+    uint32_t ulTail;
+
+    if( ( ulOwner == 0U ) || ( ulOwner > ( uint32_t ) portSHARED_TIMER_CLIENTS ) ) {
+        return;
+    }
+
+    pxClient = &( pxDispatcher->pxSegment->xClients[ ulOwner - 1U ] );
+    ulTail = pxClient->ulTail;
+
+    if( ( ulTail - portATOMIC_LOAD_ACQUIRE_U32( &( pxClient->ulHead ) ) ) >= ( uint32_t ) portSHARED_TIMER_COMPLETION_LENGTH ) {
+        /* The dispatcher never waits for a slow client. */
+        ( void ) portATOMIC_FETCH_ADD_U32( &( pxClient->ulDropped ), 1U );
+        return;
+    }
+
+    pxExpiry = &( pxClient->xExpiries[ ulTail & ( portSHARED_TIMER_COMPLETION_LENGTH - 1U ) ] );
+    pxExpiry->xRef = ( pxDispatcher->pxLocal[ ulIndex ].ulGeneration << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) ulIndex;
+    pxExpiry->ulReserved = 0U;
+    pxExpiry->ullUserData = pxSlot->ullUserData;
+    __atomic_store_n( &( pxClient->ulTail ), ulTail + 1U, __ATOMIC_SEQ_CST );
+
+    if( __atomic_exchange_n( &( pxClient->ulWaiting ), 0U, __ATOMIC_SEQ_CST ) != 0U ) {
+        prvFutexWake( &( pxClient->ulTail ) );
+    }
+}
+
+/* Delete the dispatcher's timer of slot ulIndex, invalidate outstanding
+ * references and free the slot. */
+static void prvSharedReleaseSlot( SharedTimerService_t * pxService,
+                                  uint32_t ulIndex )
+{
+    SharedTimerLocal_t * pxLocal = &( pxService->pxLocal[ ulIndex ] );
+    SharedTimerSlot_t * pxSlot = &( pxService->pxSegment->xSlots[ ulIndex ] );
+
+    if( pxLocal->ulCreated != 0U ) {
+        ( void ) xTimerDelete( ( TimerHandle_t ) &( pxLocal->xTimer ), 0 );
+        pxLocal->ulCreated = 0U;
+    }
+
+    pxLocal->ulGeneration = ( pxLocal->ulGeneration + 1U ) & portSHARED_GENERATION_MASK;
+
+    if( pxLocal->ulGeneration == 0U ) {
+        pxLocal->ulGeneration = 1U;
+    }
+
+    portATOMIC_STORE_RELEASE_U32( &( pxSlot->ulGeneration ), pxLocal->ulGeneration );
+    portATOMIC_STORE_RELEASE_U32( &( pxSlot->ulOwner ), 0U );
+}
+
+/* Free the timers and the client slot of every client whose process has
+ * exited without vSharedTimerClientDetach(). */
+static void prvSharedReapClients( SharedTimerService_t * pxService )
+{
+    SharedTimerSegment_t * pxSegment = pxService->pxSegment;
+    SharedTimerClient_t * pxClient;
+    uint32_t ulPid;
+    uint32_t x;
+    uint32_t y;
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_CLIENTS; x++ ) {
+        pxClient = &( pxSegment->xClients[ x ] );
+        ulPid = portATOMIC_LOAD_ACQUIRE_U32( &( pxClient->ulPid ) );
+
+        /* EPERM means the process exists but belongs to another user.  A pid
+         * reused by an unrelated process keeps the slot until that one
+         * exits. */
+        if( ( ulPid == 0U ) ||
+            ( ( ( pid_t ) ulPid > 0 ) && ( ( kill( ( pid_t ) ulPid, 0 ) == 0 ) || ( errno != ESRCH ) ) ) ) {
+            continue;
+        }
+
+        for( y = 0U; y < ( uint32_t ) portSHARED_TIMER_COUNT; y++ ) {
+            if( portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->xSlots[ y ].ulOwner ) ) == ( x + 1U ) ) {
+                prvSharedReleaseSlot( pxService, y );
+            }
+        }
+
+        /* Only once its timers are gone, or the next client to take the slot
+         * would inherit them. */
+        pxClient->ulWaiting = 0U;
+        portATOMIC_STORE_RELEASE_U32( &( pxClient->ulPid ), 0U );
+    }
+}
+
+static int64_t prvSharedNowMs( void )
+{
+    struct timespec xNow;
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC_COARSE, &xNow );
+
+    return ( ( int64_t ) xNow.tv_sec * 1000 ) + ( xNow.tv_nsec / 1000000L );
+}
+
+static SharedTimerService_t * prvSharedMap( const char * pcName,
+                                            int iFlags )
+{
+    SharedTimerService_t * pxService;
+    struct stat xStat;
+    void * pvMap = MAP_FAILED;
+    int iFd;
+
+    if( strlen( pcName ) > NAME_MAX ) {
+        return NULL;
+    }
+
+    pxService = ( SharedTimerService_t * ) calloc( 1, sizeof( SharedTimerService_t ) );
+
+    if( pxService == NULL ) {
+        return NULL;
+    }
+
+    iFd = shm_open( pcName, iFlags, 0600 );
+
+    if( iFd >= 0 ) {
+        if( ( iFlags & O_CREAT ) != 0 ) {
+            /* The new segment reads as zeros. */
+            if( ftruncate( iFd, ( off_t ) sizeof( SharedTimerSegment_t ) ) != 0 ) {
+                ( void ) shm_unlink( pcName );
+                ( void ) close( iFd );
+                free( pxService );
+                return NULL;
+            }
+        }
+
+        if( ( fstat( iFd, &xStat ) == 0 ) && ( ( size_t ) xStat.st_size == sizeof( SharedTimerSegment_t ) ) ) {
+            pvMap = mmap( NULL, sizeof( SharedTimerSegment_t ), PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0 );
+        }
+
+        ( void ) close( iFd );
+    }
+
+    if( pvMap == MAP_FAILED ) {
+        if( ( iFd >= 0 ) && ( ( iFlags & O_CREAT ) != 0 ) ) {
+            ( void ) shm_unlink( pcName );
+        }
+
+        free( pxService );
+        return NULL;
+    }
+
+    pxService->pxSegment = ( SharedTimerSegment_t * ) pvMap;
+    ( void ) strcpy( pxService->cName, pcName );
+
+    return pxService;
+}
+
+SharedTimerServiceHandle_t xSharedTimerServiceCreate( const char * pcName )
+{
+    SharedTimerService_t * pxService = prvSharedMap( pcName, O_RDWR | O_CREAT | O_EXCL );
+    SharedTimerSegment_t * pxSegment;
+    uint32_t x;
+
+    if( pxService == NULL ) {
+        return NULL;
+    }
+
+    pxSegment = pxService->pxSegment;
+    pxService->pxLocal = ( SharedTimerLocal_t * ) calloc( portSHARED_TIMER_COUNT, sizeof( SharedTimerLocal_t ) );
+
+    if( pxService->pxLocal == NULL ) {
+        ( void ) munmap( pxSegment, sizeof( SharedTimerSegment_t ) );
+        ( void ) shm_unlink( pcName );
+        free( pxService );
+        return NULL;
+    }
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COMMAND_LENGTH; x++ ) {
+        pxSegment->xCommands[ x ].ulSequence = x;
+    }
+
+    /* Generation 0 is never used so that tmrINVALID_TIMER_REF stays
+     * invalid. */
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        pxService->pxLocal[ x ].ulGeneration = 1U;
+        pxSegment->xSlots[ x ].ulGeneration = 1U;
+    }
+
+    pxSegment->ulSize = ( uint32_t ) sizeof( SharedTimerSegment_t );
+    pxService->llNextReapMs = prvSharedNowMs() + portSHARED_TIMER_REAP_MS;
+    pxDispatcher = pxService;
+    portATOMIC_STORE_RELEASE_U32( &( pxSegment->ulMagic ), portSHARED_MAGIC );
+
+    return pxService;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSharedTimerServiceProcess( SharedTimerServiceHandle_t xService )
+{
+    SharedTimerSegment_t * pxSegment = xService->pxSegment;
+    SharedTimerCommand_t * pxCommand;
+    SharedTimerLocal_t * pxLocal;
+    TimerHandle_t xTimer;
+    uint32_t ulCommand;
+    uint32_t ulIndex;
+    TimerRef_t xRef;
+    TickType_t xValue;
+    TickType_t xPeriod;
+    UBaseType_t uxCount;
+    int64_t llNowMs;
+
+    configASSERT( xService->ulClient == 0U );
+
+    llNowMs = prvSharedNowMs();
+
+    if( llNowMs >= xService->llNextReapMs ) {
+        prvSharedReapClients( xService );
+        xService->llNextReapMs = llNowMs + portSHARED_TIMER_REAP_MS;
+    }
+
+    /* Bounded, so busy clients cannot keep expired timers from firing.
+     * Everything read from the segment is checked, a client may have written
+     * anything there. */
+    for( uxCount = 0U; uxCount < ( UBaseType_t ) portSHARED_TIMER_COMMAND_LENGTH; uxCount++ ) {
+        pxCommand = &( pxSegment->xCommands[ xService->ulCommandHead & ( portSHARED_TIMER_COMMAND_LENGTH - 1U ) ] );
+
+        if( portATOMIC_LOAD_ACQUIRE_U32( &( pxCommand->ulSequence ) ) != ( xService->ulCommandHead + 1U ) ) {
+            break;
+        }
+
+        ulCommand = pxCommand->ulCommand;
+        xRef = pxCommand->xRef;
+        xValue = pxCommand->xValue;
+        portATOMIC_STORE_RELEASE_U32( &( pxCommand->ulSequence ), xService->ulCommandHead + ( uint32_t ) portSHARED_TIMER_COMMAND_LENGTH );
+        xService->ulCommandHead++;
+
+        ulIndex = ( uint32_t ) ( xRef & portSHARED_INDEX_MASK );
+
+        if( ulIndex >= ( uint32_t ) portSHARED_TIMER_COUNT ) {
+            continue;
+        }
+
+        pxLocal = &( xService->pxLocal[ ulIndex ] );
+
+        /* Drop commands for timers deleted since they were sent. */
+        if( pxLocal->ulGeneration != ( xRef >> configTIMER_REF_INDEX_BITS ) ) {
+            continue;
+        }
+
+        xTimer = ( TimerHandle_t ) &( pxLocal->xTimer );
+
+        if( ( pxLocal->ulCreated == 0U ) &&
+            ( ( ulCommand == portSHARED_COMMAND_START ) || ( ulCommand == portSHARED_COMMAND_CHANGE_PERIOD ) ) ) {
+            xPeriod = pxSegment->xSlots[ ulIndex ].xPeriod;
+
+            if( xPeriod == 0U ) {
+                continue;
+            }
+
+            ( void ) xTimerCreateStatic( "shared", xPeriod,
+                                         ( pxSegment->xSlots[ ulIndex ].uxAutoReload != 0U ) ? pdTRUE : pdFALSE,
+                                         ( void * ) ( uintptr_t ) ulIndex, prvSharedTimerExpired, &( pxLocal->xTimer ) );
+            pxLocal->ulCreated = 1U;
+        }
+
+        switch( ulCommand ) {
+            case portSHARED_COMMAND_START:
+                ( void ) xTimerStart( xTimer, 0 );
+                break;
+
+            case portSHARED_COMMAND_STOP:
+                if( pxLocal->ulCreated != 0U ) {
+                    ( void ) xTimerStop( xTimer, 0 );
+                }
+                break;
+
+            case portSHARED_COMMAND_CHANGE_PERIOD:
+                if( xValue != 0U ) {
+                    ( void ) xTimerChangePeriod( xTimer, xValue, 0 );
+                }
+                break;
+
+            case portSHARED_COMMAND_DELETE:
+                prvSharedReleaseSlot( xService, ulIndex );
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+void vSharedTimerServiceWait( SharedTimerServiceHandle_t xService,
+                              int32_t lTimeoutMs )
+{
+    SharedTimerSegment_t * pxSegment = xService->pxSegment;
+    uint32_t ulTail;
+
+    __atomic_store_n( &( pxSegment->ulDispatcherWaiting ), 1U, __ATOMIC_SEQ_CST );
+    ulTail = __atomic_load_n( &( pxSegment->ulCommandTail ), __ATOMIC_SEQ_CST );
+
+    /* Only sleep if the next command has not been published yet.  A
+     * producer that claimed a slot but has not published it will wake us. */
+    if( __atomic_load_n( &( pxSegment->xCommands[ xService->ulCommandHead & ( portSHARED_TIMER_COMMAND_LENGTH - 1U ) ].ulSequence ), __ATOMIC_SEQ_CST ) != ( xService->ulCommandHead + 1U ) ) {
+        prvFutexWait( &( pxSegment->ulCommandTail ), ulTail, lTimeoutMs );
+    }
+
+    __atomic_store_n( &( pxSegment->ulDispatcherWaiting ), 0U, __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+void vSharedTimerServiceDelete( SharedTimerServiceHandle_t xService )
+{
+    SharedTimerSegment_t * pxSegment = xService->pxSegment;
+    uint32_t x;
+
+    configASSERT( xService->ulClient == 0U );
+
+    /* Take the static timers out of the active lists before they are
+     * freed. */
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        if( xService->pxLocal[ x ].ulCreated != 0U ) {
+            ( void ) xTimerDelete( ( TimerHandle_t ) &( xService->pxLocal[ x ].xTimer ), 0 );
+        }
+    }
+
+    pxDispatcher = NULL;
+    free( xService->pxLocal );
+    ( void ) munmap( pxSegment, sizeof( SharedTimerSegment_t ) );
+    ( void ) shm_unlink( xService->cName );
+    free( xService );
+}
+/*-----------------------------------------------------------*/
+
+SharedTimerServiceHandle_t xSharedTimerClientAttach( const char * pcName )
+{
+    SharedTimerService_t * pxService = prvSharedMap( pcName, O_RDWR );
+    SharedTimerSegment_t * pxSegment;
+    uint32_t ulPid = ( uint32_t ) getpid();
+    uint32_t ulFree;
+    uint32_t x;
+
+    if( pxService == NULL ) {
+        return NULL;
+    }
+
+    pxSegment = pxService->pxSegment;
+
+    if( ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->ulMagic ) ) == portSHARED_MAGIC ) &&
+        ( pxSegment->ulSize == ( uint32_t ) sizeof( SharedTimerSegment_t ) ) ) {
+        for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_CLIENTS; x++ ) {
+            ulFree = 0U;
+
+            if( portATOMIC_COMPARE_EXCHANGE_U32( &( pxSegment->xClients[ x ].ulPid ), &ulFree, ulPid ) ) {
+                /* Nothing left over from the previous owner of the slot. */
+                pxSegment->xClients[ x ].ulHead = portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->xClients[ x ].ulTail ) );
+                pxService->ulClient = x + 1U;
+                return pxService;
+            }
+        }
+    }
+
+    ( void ) munmap( pxSegment, sizeof( SharedTimerSegment_t ) );
+    free( pxService );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+void vSharedTimerClientDetach( SharedTimerServiceHandle_t xService )
+{
+    SharedTimerSegment_t * pxSegment = xService->pxSegment;
+    TimerRef_t xRef;
+    uint32_t x;
+
+    configASSERT( xService->ulClient != 0U );
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        if( portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->xSlots[ x ].ulOwner ) ) == xService->ulClient ) {
+            xRef = ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSegment->xSlots[ x ].ulGeneration ) ) << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) x;
+
+            /* Spin rather than leak the timer if the ring is full. */
+            while( prvSharedSendCommand( xService, portSHARED_COMMAND_DELETE, xRef, 0U ) == pdFALSE ) {
+                if( prvSharedSlotFromRef( xService, xRef ) == NULL ) {
+                    break;
+                }
+
+                ( void ) sched_yield();
+            }
+        }
+    }
+
+    portATOMIC_STORE_RELEASE_U32( &( pxSegment->xClients[ xService->ulClient - 1U ].ulPid ), 0U );
+    ( void ) munmap( pxSegment, sizeof( SharedTimerSegment_t ) );
+    free( xService );
+}
+/*-----------------------------------------------------------*/
+
+TimerRef_t xSharedTimerCreate( SharedTimerServiceHandle_t xService,
+                               const TickType_t xTimerPeriodInTicks,
+                               const UBaseType_t uxAutoReload,
+                               uint64_t ullUserData )
+{
+    SharedTimerSegment_t * pxSegment = xService->pxSegment;
+    SharedTimerSlot_t * pxSlot;
+    uint32_t ulFree;
+    uint32_t ulIndex;
+    uint32_t x;
+
+    configASSERT( xService->ulClient != 0U );
+    configASSERT( ( xTimerPeriodInTicks > 0 ) );
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        ulIndex = ( xService->ulNextSlot + x ) % ( uint32_t ) portSHARED_TIMER_COUNT;
+        pxSlot = &( pxSegment->xSlots[ ulIndex ] );
+        ulFree = 0U;
+
+        if( ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulOwner ) ) == 0U ) &&
+            portATOMIC_COMPARE_EXCHANGE_U32( &( pxSlot->ulOwner ), &ulFree, xService->ulClient ) ) {
+            /* Published to the dispatcher by the release of the first
+             * command. */
+            pxSlot->xPeriod = xTimerPeriodInTicks;
+            pxSlot->uxAutoReload = uxAutoReload;
+            pxSlot->ullUserData = ullUserData;
+            xService->ulNextSlot = ulIndex + 1U;
+
+            return ( portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulGeneration ) ) << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) ulIndex;
+        }
+    }
+
+    return tmrINVALID_TIMER_REF;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSharedTimerStart( SharedTimerServiceHandle_t xService,
+                              TimerRef_t xRef )
+{
+    return prvSharedSendCommand( xService, portSHARED_COMMAND_START, xRef, 0U );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSharedTimerStop( SharedTimerServiceHandle_t xService,
+                             TimerRef_t xRef )
+{
+    return prvSharedSendCommand( xService, portSHARED_COMMAND_STOP, xRef, 0U );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSharedTimerChangePeriod( SharedTimerServiceHandle_t xService,
+                                     TimerRef_t xRef,
+                                     TickType_t xNewPeriod )
+{
+    configASSERT( ( xNewPeriod > 0 ) );
+
+    return prvSharedSendCommand( xService, portSHARED_COMMAND_CHANGE_PERIOD, xRef, xNewPeriod );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSharedTimerDelete( SharedTimerServiceHandle_t xService,
+                               TimerRef_t xRef )
+{
+    return prvSharedSendCommand( xService, portSHARED_COMMAND_DELETE, xRef, 0U );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSharedTimerReceive( SharedTimerServiceHandle_t xService,
+                                  SharedTimerExpiry_t * pxExpiries,
+                                  UBaseType_t uxMaxExpiries,
+                                  int32_t lTimeoutMs )
+{
+    SharedTimerClient_t * pxClient;
+    UBaseType_t uxCount = 0U;
+    uint32_t ulTail;
+
+    configASSERT( xService->ulClient != 0U );
+
+    pxClient = &( xService->pxSegment->xClients[ xService->ulClient - 1U ] );
+    ulTail = portATOMIC_LOAD_ACQUIRE_U32( &( pxClient->ulTail ) );
+
+    if( ( ulTail == pxClient->ulHead ) && ( lTimeoutMs != 0 ) ) {
+        /* Pairs with prvSharedTimerExpired(), see prvSharedSendCommand(). */
+        __atomic_store_n( &( pxClient->ulWaiting ), 1U, __ATOMIC_SEQ_CST );
+        ulTail = __atomic_load_n( &( pxClient->ulTail ), __ATOMIC_SEQ_CST );
+
+        if( ulTail == pxClient->ulHead ) {
+            prvFutexWait( &( pxClient->ulTail ), ulTail, lTimeoutMs );
+            ulTail = portATOMIC_LOAD_ACQUIRE_U32( &( pxClient->ulTail ) );
+        }
+
+        __atomic_store_n( &( pxClient->ulWaiting ), 0U, __ATOMIC_SEQ_CST );
+    }
+
+    while( ( uxCount < uxMaxExpiries ) && ( pxClient->ulHead != ulTail ) ) {
+        pxExpiries[ uxCount++ ] = pxClient->xExpiries[ pxClient->ulHead & ( portSHARED_TIMER_COMPLETION_LENGTH - 1U ) ];
+        portATOMIC_STORE_RELEASE_U32( &( pxClient->ulHead ), pxClient->ulHead + 1U );
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSharedTimerGetDropped( SharedTimerServiceHandle_t xService )
+{
+    configASSERT( xService->ulClient != 0U );
+
+    return portATOMIC_LOAD_ACQUIRE_U32( &( xService->pxSegment->xClients[ xService->ulClient - 1U ].ulDropped ) );
+}
+
+#endif /* configUSE_PORT_SHARED_TIMERS */
@@ -0,0 +1,328 @@
+/*
+ * dk_port_posix.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Helpers for running the soft timer on a POSIX host.  Nothing in here is
+ *  needed on a bare-metal target; only build dk_port_posix.c where the POSIX
+ *  APIs it uses are available.
+ */
+
+#ifndef UITLS_DK_PORT_POSIX_H_
+#define UITLS_DK_PORT_POSIX_H_
+
+#include <pthread.h>
+
+#include "dk_soft_timer.h"
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+#if ( configUSE_TIMER_SNAPSHOT == 1 )
+
+/*
+ * Write a snapshot of the active timers to pcPath.  The file is built in
+ * "<pcPath>.tmp" through a shared mapping and renamed over pcPath once it is
+ * complete, so a crash never leaves a half written snapshot behind.
+ */
+BaseType_t xTimerSnapshotSaveFile( const char * pcPath,
+                                   uint64_t ullAnchor,
+                                   TimerSnapshotKeyFunction_t pxGetKey );
+
+/*
+ * Map pcPath read-only and restore its timers with uxTimerSnapshotLoad().
+ * Returns the number of timers restored, 0 if the file is missing or invalid.
+ */
+UBaseType_t uxTimerSnapshotLoadFile( const char * pcPath,
+                                     uint64_t ullNow,
+                                     TimerSnapshotCreateFunction_t pxCreate,
+                                     void * pvContext );
+
+#endif /* configUSE_TIMER_SNAPSHOT */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+
+/*
+ * Record the timer workload to pcPath, see vTimerWorkloadRecordStart().  The
+ * file is replaced if it exists.  Returns pdFALSE if it cannot be created.
+ */
+BaseType_t xTimerWorkloadRecordFile( const char * pcPath );
+
+/* Stop recording and close the file. */
+void vTimerWorkloadRecordCloseFile( void );
+
+#endif /* configUSE_TIMER_WORKLOAD_RECORD */
+
+#if defined( configUSE_PORT_ARENA ) && ( configUSE_PORT_ARENA == 1 )
+
+/* Flags for vPortArenaConfigure(). */
+#define portARENA_HUGETLB    ( ( UBaseType_t ) 0x01U ) /* Back large blocks with MAP_HUGETLB pages, falling back to normal pages. */
+#define portARENA_THP        ( ( UBaseType_t ) 0x02U ) /* Ask for transparent huge pages (MADV_HUGEPAGE). */
+#define portARENA_STRICT     ( ( UBaseType_t ) 0x04U ) /* Fail over to no other node (MPOL_BIND rather than MPOL_PREFERRED). */
+
+/*
+ * Select where memory allocated from now on is placed: on NUMA node iNode,
+ * or wherever it is first touched if iNode is negative.  Call it from the
+ * thread that will run dk_timer_task() before dk_soft_timer_init() so the
+ * static pools are placed as well.
+ *
+ * With configUSE_PORT_ARENA set to 1, dk_typedef.h maps pvPortMalloc() and
+ * vPortFree() onto pvPortArenaMalloc() and vPortArenaFree().  Blocks of
+ * portARENA_MMAP_THRESHOLD bytes or more (timer heaps, group member arrays)
+ * get their own mapping, bound to the node and backed by huge pages as
+ * configured.  Smaller blocks (single timers) come from malloc() and are
+ * placed by first touch, which is the node of the calling thread.
+ */
+void vPortArenaConfigure( int iNode,
+                          UBaseType_t uxFlags );
+
+#endif /* configUSE_PORT_ARENA */
+
+#if defined( configUSE_PORT_RUN_LOOP ) && ( configUSE_PORT_RUN_LOOP == 1 )
+
+/* Length of one tick of ulPortRunGetTickCount(), in microseconds. */
+#ifndef portRUN_TICK_PERIOD_US
+    #define portRUN_TICK_PERIOD_US    1000
+#endif
+
+/* State of one dk_timer_run() loop.  Only touched through the functions
+ * below. */
+typedef struct xTIMER_RUN_SERVICE
+{
+    uint32_t ulSignal;   /*<< Futex word, bumped by every notification. */
+    uint32_t ulSleeping; /*<< Set while the loop waits on ulSignal. */
+    uint32_t ulWakeTick; /*<< Tick the sleeping loop will wake at on its own. */
+    uint32_t ulStop;
+    pthread_t xThread;   /*<< Dispatcher thread, see xTimerRunThreadStart(). */
+} TimerRunService_t;
+
+/*
+ * Tick source for dk_soft_timer_init() when using dk_timer_run(): the
+ * CLOCK_MONOTONIC time since the first call, in portRUN_TICK_PERIOD_US ticks.
+ * dk_timer_run() computes its deadlines from the same clock.
+ */
+uint32_t ulPortRunGetTickCount( void );
+
+void vTimerRunServiceInit( TimerRunService_t * pxService );
+
+/*
+ * Run the timer service until vTimerRunStop() is called:
+ *
+ *      dk_soft_timer_init( ulPortRunGetTickCount );
+ *      vTimerRunServiceInit( &xService );
+ *      dk_timer_run( &xService );
+ *
+ * Between expiries the calling thread sleeps on a futex with an absolute
+ * deadline at the next expiry (see xTimerGetExpectedIdleTime()), instead of
+ * polling dk_timer_task().  Other threads must arm timers with the FromISR
+ * API, xTimerPendFunctionCall() or xTimerPendFunctionCallFromISR(); the
+ * command wakes the loop early only when it may expire before the current
+ * deadline, so commands for later timers cost no system call.  Only one loop
+ * can run at a time.
+ */
+void dk_timer_run( TimerRunService_t * pxService );
+
+/* Make dk_timer_run() return.  Safe to call from any thread, including from
+ * a timer callback. */
+void vTimerRunStop( TimerRunService_t * pxService );
+
+/* Flags for TimerRunThreadConfig_t. */
+#define portRUN_THREAD_LOCK_MEMORY    ( ( UBaseType_t ) 0x01U ) /* mlockall() current and future memory, pre-faulting the timer pools and heaps. */
+
+/* Bytes of stack the dispatcher thread touches before it enters the loop. */
+#ifndef portRUN_THREAD_PREFAULT_STACK
+    #define portRUN_THREAD_PREFAULT_STACK    ( 64 * 1024 )
+#endif
+
+typedef struct xTIMER_RUN_THREAD_CONFIG
+{
+    int iCpu;              /*<< CPU the thread is pinned to, or -1 to leave it unpinned. */
+    int iPriority;         /*<< SCHED_FIFO priority, or 0 to keep the normal scheduling policy. */
+    UBaseType_t uxFlags;   /*<< portRUN_THREAD_ flags. */
+} TimerRunThreadConfig_t;
+
+/*
+ * Run dk_timer_run() on a dispatcher thread of its own, away from the
+ * application's event loop, for callbacks that need low dispatch jitter:
+ *
+ *      dk_soft_timer_init( ulPortRunGetTickCount );
+ *      vTimerRunServiceInit( &xService );
+ *      xConfig.iCpu = 3;
+ *      xConfig.iPriority = 80;
+ *      xConfig.uxFlags = portRUN_THREAD_LOCK_MEMORY;
+ *      xTimerRunThreadStart( &xService, &xConfig );
+ *
+ * The thread is created with its affinity and policy already set, so it
+ * never runs unpinned.  With portRUN_THREAD_LOCK_MEMORY every page of the
+ * process, including the static timer pools, is faulted in and locked
+ * before the thread starts, and later allocations are locked as they are
+ * made.  The thread also touches portRUN_THREAD_PREFAULT_STACK bytes of its
+ * stack, so the loop does not take page faults.
+ *
+ * Returns pdFALSE, with nothing started and no memory locked, if iCpu is not
+ * below CPU_SETSIZE or a setting cannot be applied: SCHED_FIFO and mlockall()
+ * usually need CAP_SYS_NICE and CAP_IPC_LOCK or suitable RLIMIT_RTPRIO and
+ * RLIMIT_MEMLOCK limits.  Memory stays locked after the thread stops.
+ */
+BaseType_t xTimerRunThreadStart( TimerRunService_t * pxService,
+                                 const TimerRunThreadConfig_t * pxConfig );
+
+/* Stop the dispatcher thread and wait for it to exit.  Must not be called
+ * from a timer callback. */
+void vTimerRunThreadStop( TimerRunService_t * pxService );
+
+#endif /* configUSE_PORT_RUN_LOOP */
+
+#if defined( configUSE_PORT_SHARED_TIMERS ) && ( configUSE_PORT_SHARED_TIMERS == 1 )
+
+/* Sizes of the shared segment.  Every process attaching to a segment must be
+ * built with the same values. */
+#ifndef portSHARED_TIMER_COUNT
+    #define portSHARED_TIMER_COUNT                1024
+#endif
+
+#ifndef portSHARED_TIMER_CLIENTS
+    #define portSHARED_TIMER_CLIENTS              16
+#endif
+
+/* Length of the command ring, must be a power of two. */
+#ifndef portSHARED_TIMER_COMMAND_LENGTH
+    #define portSHARED_TIMER_COMMAND_LENGTH       1024
+#endif
+
+/* Length of each client's completion ring, must be a power of two. */
+#ifndef portSHARED_TIMER_COMPLETION_LENGTH
+    #define portSHARED_TIMER_COMPLETION_LENGTH    256
+#endif
+
+/* How often, in milliseconds, the dispatcher looks for clients that exited
+ * without detaching.  Only the dispatcher uses it. */
+#ifndef portSHARED_TIMER_REAP_MS
+    #define portSHARED_TIMER_REAP_MS              1000
+#endif
+
+typedef struct tmrSharedTimerService * SharedTimerServiceHandle_t;
+
+/* One expiry delivered to the process owning the timer. */
+typedef struct xSHARED_TIMER_EXPIRY
+{
+    TimerRef_t xRef;
+    uint32_t ulReserved;
+    uint64_t ullUserData; /*<< As passed to xSharedTimerCreate(). */
+} SharedTimerExpiry_t;
+
+/*
+ * Timer service shared by the processes of one host.  A POSIX shared memory
+ * segment holds the period and user data of each timer together with a
+ * lock-free command ring and one completion ring per client process, while
+ * the timers themselves stay in the dispatcher's own memory, so a client
+ * that writes over the segment cannot corrupt the dispatcher's lists.
+ * Clients in any process arm timers by
+ * posting commands, and a single dispatcher process runs the only
+ * dk_timer_task() loop and posts every expiry to the ring of the process
+ * that owns the timer, so N worker processes cost one set of wakeups instead
+ * of N.  Callbacks run in the owning process, after uxSharedTimerReceive().
+ *
+ * The dispatcher:
+ *
+ *      dk_soft_timer_init( getTicks );
+ *      xService = xSharedTimerServiceCreate( "/dk_timers" );
+ *      for( ; ; ) {
+ *          ( void ) uxSharedTimerServiceProcess( xService );
+ *          dk_timer_task();
+ *          vSharedTimerServiceWait( xService, 1 );
+ *      }
+ *
+ * A worker:
+ *
+ *      xService = xSharedTimerClientAttach( "/dk_timers" );
+ *      xRef = xSharedTimerCreate( xService, 100, pdTRUE, ullConnection );
+ *      ( void ) xSharedTimerStart( xService, xRef );
+ *      uxCount = uxSharedTimerReceive( xService, xExpiries, 16, -1 );
+ *
+ * Waits use a futex word inside the segment, so the processes do not have to
+ * be related.  Every portSHARED_TIMER_REAP_MS the dispatcher checks the pid
+ * of each client with kill( pid, 0 ), and deletes the timers and frees the
+ * client slot of a process that died without vSharedTimerClientDetach().
+ */
+
+/*
+ * Create the segment pcName (see shm_open()) and become its dispatcher.
+ * dk_soft_timer_init() must have been called.  Returns NULL if the segment
+ * already exists or cannot be created.
+ */
+SharedTimerServiceHandle_t xSharedTimerServiceCreate( const char * pcName );
+
+/*
+ * Apply the commands posted since the last call, and reclaim the slots of
+ * dead clients when portSHARED_TIMER_REAP_MS has passed.  Call it from the
+ * dispatcher loop, in the context of dk_timer_task().  Returns the number of
+ * commands applied.
+ */
+UBaseType_t uxSharedTimerServiceProcess( SharedTimerServiceHandle_t xService );
+
+/*
+ * Sleep until a command is posted or lTimeoutMs milliseconds have passed.  A
+ * negative timeout waits for ever.
+ */
+void vSharedTimerServiceWait( SharedTimerServiceHandle_t xService,
+                              int32_t lTimeoutMs );
+
+/* Unmap and remove the segment.  Attached clients keep their mapping. */
+void vSharedTimerServiceDelete( SharedTimerServiceHandle_t xService );
+
+/* Attach to an existing segment as a client.  Returns NULL if the segment is
+ * missing, built with other sizes, or has no free client slot. */
+SharedTimerServiceHandle_t xSharedTimerClientAttach( const char * pcName );
+
+/* Delete the timers this client still owns and release its slot. */
+void vSharedTimerClientDetach( SharedTimerServiceHandle_t xService );
+
+/*
+ * Claim a timer owned by this client.  Nothing is sent to the dispatcher
+ * until the timer is started.  Returns tmrINVALID_TIMER_REF if every timer
+ * of the segment is in use.
+ */
+TimerRef_t xSharedTimerCreate( SharedTimerServiceHandle_t xService,
+                               const TickType_t xTimerPeriodInTicks,
+                               const UBaseType_t uxAutoReload,
+                               uint64_t ullUserData );
+
+/*
+ * Post a command for a timer this client owns.  They never block and return
+ * pdFALSE if xRef is stale or the command ring is full.  The dispatcher
+ * applies the command at its next uxSharedTimerServiceProcess(), using its
+ * own tick count as the command time.
+ */
+BaseType_t xSharedTimerStart( SharedTimerServiceHandle_t xService,
+                              TimerRef_t xRef );
+BaseType_t xSharedTimerStop( SharedTimerServiceHandle_t xService,
+                             TimerRef_t xRef );
+BaseType_t xSharedTimerChangePeriod( SharedTimerServiceHandle_t xService,
+                                     TimerRef_t xRef,
+                                     TickType_t xNewPeriod );
+BaseType_t xSharedTimerDelete( SharedTimerServiceHandle_t xService,
+                               TimerRef_t xRef );
+
+/*
+ * Take up to uxMaxExpiries expiries of this client's timers from its
+ * completion ring, waiting up to lTimeoutMs milliseconds (for ever if
+ * negative) for the first one.  Returns the number taken.
+ */
+UBaseType_t uxSharedTimerReceive( SharedTimerServiceHandle_t xService,
+                                  SharedTimerExpiry_t * pxExpiries,
+                                  UBaseType_t uxMaxExpiries,
+                                  int32_t lTimeoutMs );
+
+/* Expiries dropped because this client's completion ring was full. */
+uint32_t ulSharedTimerGetDropped( SharedTimerServiceHandle_t xService );
+
+#endif /* configUSE_PORT_SHARED_TIMERS */
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* UITLS_DK_PORT_POSIX_H_ */
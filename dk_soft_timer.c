@@ -15,10 +15,112 @@
 #define tmrSTATUS_IS_ACTIVE                  ( ( uint8_t ) 0x01 )
 #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x02 )
 #define tmrSTATUS_IS_AUTORELOAD              ( ( uint8_t ) 0x04 )
+#define tmrSTATUS_IS_LAZY_RESET              ( ( uint8_t ) 0x08 )
+#define tmrSTATUS_RESET_PENDING              ( ( uint8_t ) 0x10 )
+#define tmrSTATUS_IS_RESCHEDULING            ( ( uint8_t ) 0x20 )
 
 #define taskENTER_CRITICAL()
 #define taskEXIT_CRITICAL()
 
+#if ( configUSE_TIMER_TRACE == 1 )
+    #include "dk_timer_trace.h"
+
+    typedef char prvTraceLengthCheck[ ( ( configTIMER_TRACE_BUFFER_LENGTH & ( configTIMER_TRACE_BUFFER_LENGTH - 1 ) ) == 0 ) ? 1 : -1 ];
+
+    #define traceTIMER_START( pxTimer, xExpiry )            prvTraceRecord( tmrTRACE_EVENT_START, prvTraceTimerId( pxTimer ), ( xExpiry ) )
+    #define traceTIMER_STOP( pxTimer )                      prvTraceRecord( tmrTRACE_EVENT_STOP, prvTraceTimerId( pxTimer ), 0U )
+    #define traceTIMER_CHANGE_PERIOD( pxTimer, xPeriod )    prvTraceRecord( tmrTRACE_EVENT_CHANGE_PERIOD, prvTraceTimerId( pxTimer ), ( xPeriod ) )
+    #define traceTIMER_EXPIRED( pxTimer, xExpiry )          prvTraceRecord( tmrTRACE_EVENT_EXPIRED, prvTraceTimerId( pxTimer ), ( xExpiry ) )
+#endif
+
+/* Trace hooks, in the style of the FreeRTOS trace macros.  They compile away
+ * unless configUSE_TIMER_TRACE is set or the application defines them. */
+#ifndef traceTIMER_START
+    #define traceTIMER_START( pxTimer, xExpiry )
+#endif
+#ifndef traceTIMER_STOP
+    #define traceTIMER_STOP( pxTimer )
+#endif
+#ifndef traceTIMER_CHANGE_PERIOD
+    #define traceTIMER_CHANGE_PERIOD( pxTimer, xPeriod )
+#endif
+#ifndef traceTIMER_EXPIRED
+    #define traceTIMER_EXPIRED( pxTimer, xExpiry )
+#endif
+
+#if ( configUSE_TIMER_USDT == 1 )
+    /* With semaphores a tracer marks the probes it attaches to, which lets
+     * tmrPROBE_ENABLED() skip arguments that are costly to compute.  Every
+     * probe in this file then needs its semaphore. */
+    #define _SDT_HAS_SEMAPHORES    1
+    #include <sys/sdt.h>
+
+    #define tmrPROBE_SEMAPHORE( name )    __extension__ unsigned short dk_soft_timer_##name##_semaphore __attribute__( ( used, section( ".probes" ) ) )
+
+    tmrPROBE_SEMAPHORE( start );
+    tmrPROBE_SEMAPHORE( stop );
+    tmrPROBE_SEMAPHORE( insert );
+    tmrPROBE_SEMAPHORE( expired );
+    tmrPROBE_SEMAPHORE( reload_catchup );
+    tmrPROBE_SEMAPHORE( switch_lists );
+
+    #define tmrPROBE_ENABLED( name )                 __builtin_expect( dk_soft_timer_##name##_semaphore != 0U, 0 )
+    #define tmrPROBE1( name, a1 )                    DTRACE_PROBE1( dk_soft_timer, name, a1 )
+    #define tmrPROBE2( name, a1, a2 )                DTRACE_PROBE2( dk_soft_timer, name, a1, a2 )
+    #define tmrPROBE3( name, a1, a2, a3 )            DTRACE_PROBE3( dk_soft_timer, name, a1, a2, a3 )
+#else
+    #define tmrPROBE_ENABLED( name )                 ( 0 )
+    #define tmrPROBE1( name, a1 )
+    #define tmrPROBE2( name, a1, a2 )
+    #define tmrPROBE3( name, a1, a2, a3 )
+#endif /* configUSE_TIMER_USDT */
+
+#if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+
+    /* Only the timer service writes timer state, so the writer side of the
+     * sequence counter needs no read-modify-write.  The sections must not
+     * nest on the same timer and must not call out of this file. */
+    #define tmrBEGIN_STATE_WRITE( pxTimer )                                                      \
+    do {                                                                                         \
+        portATOMIC_STORE_RELEASE_U32( &( ( pxTimer )->ulSequence ), ( pxTimer )->ulSequence + 1U ); \
+        portATOMIC_THREAD_FENCE_RELEASE();                                                       \
+    } while( 0 )
+
+    #define tmrEND_STATE_WRITE( pxTimer )    portATOMIC_STORE_RELEASE_U32( &( ( pxTimer )->ulSequence ), ( pxTimer )->ulSequence + 1U )
+
+    /* ucStatus and xTimerPeriodInTicks are also read outside any write
+     * section, so once a timer has been handed out they are only stored
+     * whole.  The timer service is their only writer and reads them
+     * plainly. */
+    #define tmrLOAD_STATUS( pxTimer )                portATOMIC_LOAD_RELAXED_U8( &( ( pxTimer )->ucStatus ) )
+    #define tmrSET_STATUS( pxTimer, ucBits )         portATOMIC_STORE_RELAXED_U8( &( ( pxTimer )->ucStatus ), ( uint8_t ) ( ( pxTimer )->ucStatus | ( ucBits ) ) )
+    #define tmrCLEAR_STATUS( pxTimer, ucBits )       portATOMIC_STORE_RELAXED_U8( &( ( pxTimer )->ucStatus ), ( uint8_t ) ( ( pxTimer )->ucStatus & ( uint8_t ) ~( ucBits ) ) )
+    #define tmrLOAD_PERIOD( pxTimer )                portATOMIC_LOAD_RELAXED_U32( &( ( pxTimer )->xTimerPeriodInTicks ) )
+    #define tmrSTORE_PERIOD( pxTimer, xPeriod )      portATOMIC_STORE_RELAXED_U32( &( ( pxTimer )->xTimerPeriodInTicks ), ( xPeriod ) )
+#else
+    #define tmrBEGIN_STATE_WRITE( pxTimer )
+    #define tmrEND_STATE_WRITE( pxTimer )
+
+    #define tmrLOAD_STATUS( pxTimer )                ( ( pxTimer )->ucStatus )
+    #define tmrSET_STATUS( pxTimer, ucBits )         ( ( pxTimer )->ucStatus |= ( uint8_t ) ( ucBits ) )
+    #define tmrCLEAR_STATUS( pxTimer, ucBits )       ( ( pxTimer )->ucStatus &= ( uint8_t ) ~( ucBits ) )
+    #define tmrLOAD_PERIOD( pxTimer )                ( ( pxTimer )->xTimerPeriodInTicks )
+    #define tmrSTORE_PERIOD( pxTimer, xPeriod )      ( ( pxTimer )->xTimerPeriodInTicks = ( xPeriod ) )
+#endif /* configUSE_TIMER_CONCURRENT_READS */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+    #include "dk_timer_workload.h"
+
+    #define tmrRECORD_WORKLOAD( ucOp, pxTimer, ulValue, ucFlags )                                                            \
+    do {                                                                                                                  \
+        if( pxWorkloadWrite != NULL ) {                                                                                   \
+            prvWorkloadRecord( ( ucOp ), sys_get_TickCount(), ( pxTimer )->ulWorkloadId, ( ulValue ), ( ucFlags ) );           \
+        }                                                                                                                 \
+    } while( 0 )
+#else
+    #define tmrRECORD_WORKLOAD( ucOp, pxTimer, ulValue, ucFlags )
+#endif
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl                  /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -28,14 +130,316 @@ typedef struct tmrTimerControl                  /* The old naming convention is
     void * pvTimerID;                           /*<< An ID to identify the timer.  This allows the timer to be identified when the same callback is used for multiple timers. */
     TimerCallbackFunction_t pxCallbackFunction; /*<< The function that will be called when the timer expires. */
     uint8_t ucStatus;                           /*<< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+        UBaseType_t uxHeapIndex;                /*<< Position of the timer in its heap while the heaps are in use. */
+    #endif
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        struct tmrPeriodGroup * pxPeriodGroup;  /*<< The period group the timer is a member of, or NULL. */
+        UBaseType_t uxGroupIndex;               /*<< Position of the timer in the member array of its group. */
+    #endif
+    #if ( configUSE_TIMER_LAZY_RESET == 1 )
+        TickType_t xLazyExpiryTime;             /*<< Deadline recorded by a lazy reset, valid while tmrSTATUS_RESET_PENDING is set. */
+    #endif
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        uint32_t ulCallbackMaxTime;             /*<< Longest run of the callback, in run time counter units. */
+        uint64_t ullCallbackTotalTime;          /*<< Sum of all runs of the callback. */
+    #endif
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        uint32_t ulSequence;                    /*<< Odd while the timer service changes the state read by xTimerGetExpiryTime(). */
+    #endif
+    #if ( configUSE_TIMER_GROUPS == 1 )
+        ListItem_t xGroupListItem;              /*<< Links the timer into the member list of its timer group, if it is in one. */
+    #endif
+    #if ( configUSE_TIMER_BACKOFF == 1 )
+        const TimerBackoffPolicy_t * pxBackoffPolicy; /*<< NULL unless the timer is a backoff timer. */
+        TickType_t xBackoffDelay;               /*<< Delay of the current retry before jitter, what the next one grows from. */
+    #endif
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        uint8_t ucPriorityClass;                /*<< Order of the callback among the timers due in the same pass, higher first. */
+    #endif
+    #if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+        uint32_t ulWorkloadId;                  /*<< Identifies the timer in a workload recording, see TimerWorkloadRecord_t. */
+    #endif
 } xTIMER;
 
 typedef xTIMER Timer_t;
 
+/* StaticTimer_t must be able to hold a Timer_t.  Fail the build if the two
+ * structures have drifted apart. */
+typedef char prvStaticTimerSizeCheck[ ( sizeof( StaticTimer_t ) == sizeof( Timer_t ) ) ? 1 : -1 ];
+
+#if ( configTIMER_POOL_SIZE > 0 )
+    #define tmrREF_INDEX_MASK         ( ( ( TimerRef_t ) 1U << configTIMER_REF_INDEX_BITS ) - 1U )
+    #define tmrREF_GENERATION_MASK    ( ( ( TimerRef_t ) 0xffffffffUL ) >> configTIMER_REF_INDEX_BITS )
+
+    typedef char prvTimerPoolSizeCheck[ ( configTIMER_POOL_SIZE <= tmrREF_INDEX_MASK ) ? 1 : -1 ];
+
+    /* Timers handed out by xTimerCreate().  Free timers are linked into
+     * xFreeTimerList through their own xTimerListItem, oldest first, so a
+     * slot is reused as late as possible. */
+    static Timer_t xTimerPool[ configTIMER_POOL_SIZE ];
+    static TimerRef_t xTimerPoolGeneration[ configTIMER_POOL_SIZE ];
+    static List_t xFreeTimerList;
+#endif
+
+#if ( configUSE_TIMER_TRACE == 1 )
+    /* Written from any context with a single atomic increment of the write
+     * index; the oldest records are overwritten once the ring is full. */
+    static TimerTraceRecord_t xTraceBuffer[ configTIMER_TRACE_BUFFER_LENGTH ];
+    static uint32_t ulTraceWriteIndex;
+#endif
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+    static TimerWorkloadWriteFunction_t pxWorkloadWrite = NULL; /*<< NULL while not recording. */
+    static void * pvWorkloadContext;
+    static TimerWorkloadRecord_t xWorkloadBuffer[ configTIMER_WORKLOAD_BUFFER_LENGTH ];
+    static UBaseType_t uxWorkloadCount;
+    static uint32_t ulWorkloadLastId = 0U; /*<< Given to the timer created last, 0 is never given. */
+#endif
+
+#if ( configTIMER_QUEUE_LENGTH > 0 )
+    typedef char prvTimerQueueLengthCheck[ ( ( configTIMER_QUEUE_LENGTH & ( configTIMER_QUEUE_LENGTH - 1 ) ) == 0 ) ? 1 : -1 ];
+
+    #define tmrQUEUE_INDEX_MASK    ( ( uint32_t ) configTIMER_QUEUE_LENGTH - 1U )
+
+    /* The definition of messages that can be sent and received on the timer
+     * queue. */
+    typedef struct tmrTimerParameters
+    {
+        TickType_t xMessageValue; /*<< An optional value used by a subset of commands, for example, when changing the period of a timer. */
+        Timer_t * pxTimer;        /*<< The timer to which the command will be applied. */
+        #if ( configTIMER_POOL_SIZE > 0 )
+            TimerRef_t xTimerRef; /*<< Checked before the command is applied, the timer may have been deleted meanwhile. */
+        #endif
+    } TimerParameter_t;
+
+    typedef struct tmrCallbackParameters
+    {
+        PendedFunction_t pxCallbackFunction; /* << The callback function to execute. */
+        void * pvParameter1;                 /* << The value that will be used as the callback functions first parameter. */
+        uint32_t ulParameter2;               /* << The value that will be used as the callback functions second parameter. */
+    } CallbackParameters_t;
+
+    typedef struct tmrTimerQueueMessage
+    {
+        BaseType_t xMessageID; /*<< The command being sent to the timer service task. */
+        union
+        {
+            TimerParameter_t xTimerParameters;
+            CallbackParameters_t xCallbackParameters;
+        } u;
+    } DaemonTaskMessage_t;
+
+    /*
+     * Bounded multi-producer single-consumer ring.  A producer claims a slot
+     * by advancing ulQueueTail with a compare-exchange and then publishes the
+     * message by setting the slot sequence to position + 1.  The consumer only
+     * takes a slot whose sequence says it has been published, and frees it by
+     * setting the sequence to position + configTIMER_QUEUE_LENGTH.
+     */
+    typedef struct tmrQueueSlot
+    {
+        uint32_t ulSequence;
+        DaemonTaskMessage_t xMessage;
+    } TimerQueueSlot_t;
+
+    static TimerQueueSlot_t xTimerQueue[ configTIMER_QUEUE_LENGTH ];
+    static uint32_t ulQueueTail;
+    static uint32_t ulQueueHead; /* Only touched by dk_timer_task(). */
+#endif /* configTIMER_QUEUE_LENGTH */
+
+#if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+
+    /* Smallest member array allocated, in timers. */
+    #define tmrGROUP_MIN_CAPACITY    ( ( UBaseType_t ) 8U )
+
+    typedef struct tmrPeriodGroup
+    {
+        Timer_t xAnchor;            /*<< The one entry in the active lists, its callback fans out to the members. */
+        Timer_t ** ppxMembers;
+        UBaseType_t uxCount;        /*<< Used entries of ppxMembers, including holes. */
+        UBaseType_t uxCapacity;
+        UBaseType_t uxHoles;        /*<< Members removed while dispatching, their entries are NULL. */
+        BaseType_t xDispatching;
+        #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+            struct tmrPeriodGroup * pxNextFree;
+        #endif
+    } PeriodGroup_t;
+
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        /* Deleted groups, kept for the next xTimerPeriodGroupCreate() rather
+         * than freed as xTimerGetExpiryTime() may still be reading the anchor
+         * of a group one of its members just left. */
+        static PeriodGroup_t * pxFreePeriodGroups = NULL;
+    #endif
+
+    /* Members of all groups, which xTimerSnapshotSize() has to allow for as
+     * they are not in the active lists. */
+    static UBaseType_t uxPeriodGroupMembers;
+
+    /* Take pxTimer out of its period group, if it is in one. */
+    #define tmrLEAVE_PERIOD_GROUP( pxTimer )              \
+    do {                                                  \
+        if( ( pxTimer )->pxPeriodGroup != NULL ) {        \
+            prvPeriodGroupRemove( pxTimer );              \
+        }                                                 \
+    } while( 0 )
+#else
+    #define tmrLEAVE_PERIOD_GROUP( pxTimer )
+#endif /* configUSE_TIMER_PERIOD_GROUPS */
+
+#if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+    typedef char prvPriorityClassesCheck[ ( ( configTIMER_PRIORITY_CLASSES > 0 ) && ( configTIMER_PRIORITY_CLASSES <= 256 ) ) ? 1 : -1 ];
+
+    /* Due timers waiting for their callback, one FIFO per class.  A timer
+     * is linked in through its xTimerListItem, which still holds the time
+     * it expired at. */
+    static List_t xDueTimerLists[ configTIMER_PRIORITY_CLASSES ];
+    static UBaseType_t uxClassBudget[ configTIMER_PRIORITY_CLASSES ];
+
+    /* pdTRUE if pxTimer is waiting in one of the active lists, rather than
+     * in a due list or no list at all. */
+    #define tmrIS_IN_ACTIVE_LIST( pxTimer )                                                        \
+    ( ( listIS_CONTAINED_WITHIN( &xActiveTimerList1, &( ( pxTimer )->xTimerListItem ) ) != pdFALSE ) || \
+      ( listIS_CONTAINED_WITHIN( &xActiveTimerList2, &( ( pxTimer )->xTimerListItem ) ) != pdFALSE ) )
+#else
+    #define tmrIS_IN_ACTIVE_LIST( pxTimer )    ( listIS_CONTAINED_WITHIN( NULL, &( ( pxTimer )->xTimerListItem ) ) == pdFALSE )
+#endif
+
+#if ( configUSE_TIMER_BACKOFF == 1 )
+    #define tmrBACKOFF_DEFAULT_SEED    ( ( uint32_t ) 0x9e3779b9UL )
+
+    /* xorshift32 state, only touched by the timer service. */
+    static uint32_t ulBackoffRandom = tmrBACKOFF_DEFAULT_SEED;
+#endif
+
+#if ( configUSE_TIMER_GROUPS == 1 )
+    typedef struct tmrTimerGroup
+    {
+        List_t xMembers;  /*<< Owned by the member timers, in the order they joined. */
+        uint8_t ucStatus; /*<< tmrSTATUS_IS_STATICALLY_ALLOCATED or 0. */
+    } TimerGroup_t;
+
+    typedef char prvStaticTimerGroupSizeCheck[ ( sizeof( StaticTimerGroup_t ) == sizeof( TimerGroup_t ) ) ? 1 : -1 ];
+
+    /* Take pxTimer out of its timer group, if it is in one. */
+    #define tmrLEAVE_TIMER_GROUP( pxTimer )                                                    \
+    do {                                                                                       \
+        if( listIS_CONTAINED_WITHIN( NULL, &( ( pxTimer )->xGroupListItem ) ) == pdFALSE ) {   \
+            ( void ) uxListRemove( &( ( pxTimer )->xGroupListItem ) );                         \
+        }                                                                                      \
+    } while( 0 )
+#else
+    #define tmrLEAVE_TIMER_GROUP( pxTimer )
+#endif /* configUSE_TIMER_GROUPS */
+
+#if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+    #define tmrCOMPACT_INDEX_MASK         ( ( ( TimerRef_t ) 1U << configTIMER_REF_INDEX_BITS ) - 1U )
+    #define tmrCOMPACT_GENERATION_MASK    ( ( ( TimerRef_t ) 0xffffffffUL ) >> configTIMER_REF_INDEX_BITS )
+    #define tmrCOMPACT_NO_INDEX           ( ( uint32_t ) 0xffffffffUL )
+
+    typedef char prvCompactPoolSizeCheck[ ( configTIMER_COMPACT_POOL_SIZE <= tmrCOMPACT_INDEX_MASK ) ? 1 : -1 ];
+    typedef char prvCompactGenerationCheck[ ( tmrCOMPACT_GENERATION_MASK <= 0xffffU ) ? 1 : -1 ];
+    typedef char prvCompactCallbacksCheck[ ( configTIMER_COMPACT_MAX_CALLBACKS <= 256 ) ? 1 : -1 ];
+    typedef char prvCompactExpiriesCheck[ ( configTIMER_COMPACT_MAX_EXPIRIES > 0 ) ? 1 : -1 ];
+
+    /* 16 bytes.  Free records are chained through ulLink and keep the
+     * generation their next timer will get in xExpiryTime. */
+    typedef struct tmrCompactTimer
+    {
+        TickType_t xExpiryTime;
+        TickType_t xTimerPeriodInTicks;
+        uint32_t ulLink;            /*<< Heap position while running, next free record while free. */
+        uint16_t usGeneration;      /*<< 0 while the record is free. */
+        uint8_t ucCallbackIndex;
+        uint8_t ucStatus;
+    } CompactTimer_t;
+
+    typedef char prvCompactRecordSizeCheck[ ( sizeof( CompactTimer_t ) == 16U ) ? 1 : -1 ];
+
+    static CompactTimer_t xCompactTimers[ configTIMER_COMPACT_POOL_SIZE ];
+    static uint32_t ulCompactHeap[ configTIMER_COMPACT_POOL_SIZE ];
+    static uint32_t ulCompactHeapCount;
+    static uint32_t ulCompactFreeHead;
+    static CompactTimerCallbackFunction_t pxCompactCallbacks[ configTIMER_COMPACT_MAX_CALLBACKS ];
+    static UBaseType_t uxCompactCallbackCount;
+
+    /*
+     * The heap is ordered on the expiry time relative to xCompactBase, a time
+     * at or before the expiry of every running compact timer.  The base only
+     * moves up to "now" once nothing is due, so every key shrinks by the same
+     * amount and the order holds across tick wraparound without keeping a
+     * second (overflow) heap.
+     */
+    static TickType_t xCompactBase;
+
+    #if ( configTIMER_COMPACT_STORE_ID == 1 )
+        static void * pvCompactTimerIDs[ configTIMER_COMPACT_POOL_SIZE ];
+    #endif
+#endif /* configTIMER_COMPACT_POOL_SIZE */
+
+#if ( configUSE_TIMER_PERIOD_STATS == 1 )
+    /* Slots per level of the timing wheel vTimerRecommendTuning() sizes. */
+    #define tmrWHEEL_LEVEL_BITS    6U
+
+    static TimerPeriodStats_t xPeriodStats;
+#endif
+
+#if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+    static TimerBatchCallbackFunction_t pxBatchCallback = NULL;
+    static TimerHandle_t xBatchTimers[ configTIMER_BATCH_SIZE ];
+    static UBaseType_t uxBatchCount = 0U;
+    static BaseType_t xBatchCollecting = pdFALSE; /*<< Only set while dk_timer_task() collects, and no callback is running. */
+#endif
+
+#if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+    /* One per running callback, innermost first, as callbacks nest when one
+     * starts a timer that is already due.  xTimerDelete() clears the timer of
+     * every frame it matches so its statistics are not written afterwards. */
+    typedef struct tmrCallbackFrame
+    {
+        Timer_t * pxTimer;
+        struct tmrCallbackFrame * pxOuter;
+    } CallbackFrame_t;
+
+    static CallbackFrame_t * pxCallbackFrames = NULL;
+#endif
+
 static List_t xActiveTimerList1;
 static List_t xActiveTimerList2;
 static List_t * pxCurrentTimerList;
 static List_t * pxOverflowTimerList;
+static TickType_t xLastTime = ( TickType_t ) 0U; /*<< Tick count at which the lists were last checked for a wraparound. */ /*lint !e956 Variable is only accessible to one task. */
+
+#if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+
+    /* Smallest heap array allocated, in timers. */
+    #define tmrHEAP_MIN_CAPACITY    ( ( UBaseType_t ) 16U )
+
+    /*
+     * While the heaps are in use each active list keeps its uxNumberOfItems
+     * and each timer's pxContainer still names the list it is in, so the
+     * list macros that only look at those stay valid.  The links of the
+     * list and its items are unused and the timers are held in the heap
+     * associated with the list instead, ordered on xItemValue.
+     */
+    typedef struct xTIMER_HEAP
+    {
+        Timer_t ** ppxTimers;
+        UBaseType_t uxCapacity;
+    } TimerHeap_t;
+
+    static TimerHeap_t xActiveTimerHeap1;
+    static TimerHeap_t xActiveTimerHeap2;
+    static BaseType_t xHeapsInUse = pdFALSE;
+    static UBaseType_t uxBackend = tmrBACKEND_ADAPTIVE;
+    static TickType_t xLowCountSince;
+    static BaseType_t xLowCountSeen = pdFALSE;
+
+    #define tmrHEAPS_IN_USE()    ( xHeapsInUse != pdFALSE )
+#else
+    #define tmrHEAPS_IN_USE()    ( pdFALSE )
+#endif
 
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
@@ -57,11 +461,29 @@ static List_t * pxOverflowTimerList;
 
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
- * auto-reload timer, then call its callback.
+ * auto-reload timer, then call its callback.  With priority classes the
+ * timer is only queued for prvDispatchDueTimers().
  */
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+/*
+ * pxTimer, which is no longer in any list, expired at xNextExpireTime.
+ * Reload or stop it, then call its callback.
+ */
+    static void prvExpireTimer( Timer_t * const pxTimer,
+                                const TickType_t xNextExpireTime,
+                                const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+
+/*
+ * Call the callbacks of the queued due timers, highest class first, within
+ * the class budgets.
+ */
+    static void prvDispatchDueTimers( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
@@ -82,6 +504,201 @@ static List_t * pxOverflowTimerList;
  */
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
     
+/*
+ * Add pxTimer, whose list item already holds its expiry time, to pxList, or
+ * remove it from whichever active list it is in.  These hide whether the
+ * active lists are currently sorted lists or heaps.
+ */
+    static void prvActiveListInsert( List_t * const pxList,
+                                     Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+    static void prvActiveListRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the timer that expires first in pxList, which must not be empty.
+ */
+    static Timer_t * prvActiveListHead( List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_BACKOFF == 1 )
+
+/*
+ * Return xDelay shortened by the jitter of pxPolicy.
+ */
+    static TickType_t prvBackoffJitter( const TimerBackoffPolicy_t * const pxPolicy,
+                                        TickType_t xDelay ) PRIVILEGED_FUNCTION;
+
+/*
+ * Start a new series of delays at the base delay of the backoff timer
+ * pxTimer.
+ */
+    static void prvBackoffRestart( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Grow the delay of the backoff timer pxTimer, which has just expired, and
+ * insert it for its next retry relative to xTimeNow.
+ */
+    static void prvBackoffTimer( Timer_t * const pxTimer,
+                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Call the callback of pxTimer.  The timer must not be accessed once the
+ * callback has returned as the callback is allowed to delete it, unless the
+ * return value, which is the delay returned by the callback of a rescheduling
+ * timer, is not tmrRESCHEDULE_STOP.
+ */
+    static TickType_t prvCallTimerCallback( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_USDT == 1 )
+
+/*
+ * Return how many timers the insertion of pxTimer, which has just been added
+ * to an active list, had to step over.
+ */
+    static UBaseType_t prvProbeWalkLength( const Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+
+/*
+ * Pass the collected expiries to the batch callback.
+ */
+    static void prvBatchFlush( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TIMER_ITERATOR == 1 )
+
+/*
+ * Ticks from the time the iteration started until xKey, a key in the list of
+ * the current pass.
+ */
+    static TickType_t prvIteratorRemaining( const TimerIterator_t * const pxIterator,
+                                            const TickType_t xKey ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the iterator to pass uxPass.
+ */
+    static void prvIteratorEnterPass( TimerIterator_t * const pxIterator,
+                                      const UBaseType_t uxPass ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+
+/*
+ * Return the heap position of the first timer in pxList after the one
+ * returned last that expires within the window, or tmrITERATOR_NONE.
+ */
+        static UBaseType_t prvIteratorNextInHeap( TimerIterator_t * const pxIterator,
+                                                  List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+        #if ( configTIMER_ITERATOR_FRONTIER > 0 )
+
+/*
+ * Add heap position uxIndex of ppxTimers to the frontier of pxIterator.
+ * Returns pdFALSE if the frontier is full.
+ */
+            static BaseType_t prvIteratorFrontierPush( TimerIterator_t * const pxIterator,
+                                                       Timer_t * const * const ppxTimers,
+                                                       UBaseType_t uxIndex ) PRIVILEGED_FUNCTION;
+        #endif
+    #endif
+#endif /* configUSE_TIMER_ITERATOR */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+    static void prvWorkloadRecord( uint8_t ucOp,
+                                   TickType_t xTick,
+                                   uint32_t ulTimer,
+                                   uint32_t ulValue,
+                                   uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TIMER_TRACE == 1 )
+    static uint32_t prvTraceTimerId( const Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+    static void prvTraceRecord( uint16_t usEvent,
+                                uint32_t ulTimer,
+                                uint32_t ulValue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Start pxTimer as if the start command was issued at xCommandTime, calling
+ * its callback straight away if that puts the expiry at or before xTimeNow.
+ */
+    static void prvStartTimer( Timer_t * const pxTimer,
+                               const TickType_t xCommandTime,
+                               const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+#if ( configTIMER_QUEUE_LENGTH > 0 )
+
+/*
+ * Copy *pxMessage into the timer queue.  Returns pdFALSE if the queue is full.
+ */
+    static BaseType_t prvSendMessage( const DaemonTaskMessage_t * const pxMessage ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by dk_timer_task() to apply the commands posted to the timer queue
+ * since it last ran.
+ */
+    static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+
+/*
+ * Remove pxTimer from its period group in O(1), stopping the group when its
+ * last member leaves.
+ */
+    static void prvPeriodGroupRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Callback of the anchor timer of every period group.
+ */
+    static void prvPeriodGroupCallback( TimerHandle_t xAnchor ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * The time at which pxTimer will next expire, taking a pending lazy reset and
+ * period groups into account.
+ */
+    static TickType_t prvGetTimerExpiryTime( const Timer_t * pxTimer ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+
+/*
+ * Return the sequence counter of pxTimer once it is even, that is once no
+ * write section is in progress.
+ */
+    static uint32_t prvReadSequenceBegin( const Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+
+/*
+ * Return the compact timer xRef refers to, or NULL if it has been deleted.
+ */
+    static CompactTimer_t * prvCompactFromRef( TimerRef_t xRef ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add the record at ulIndex to, or remove it from, the compact heap.
+ */
+    static void prvCompactHeapInsert( uint32_t ulIndex ) PRIVILEGED_FUNCTION;
+    static void prvCompactHeapRemove( uint32_t ulIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Expire the due compact timers, at most configTIMER_COMPACT_MAX_EXPIRIES of
+ * them, called by dk_timer_task().
+ */
+    static void prvProcessExpiredCompactTimers( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_TIMER_PERIOD_STATS == 1 )
+
+/*
+ * Add xPeriod to the period statistics.
+ */
+    static void prvRecordPeriod( const TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+    #define tmrRECORD_PERIOD( xPeriod )    prvRecordPeriod( xPeriod )
+#else
+    #define tmrRECORD_PERIOD( xPeriod )
+#endif
+
     static getSysTickCount_t sys_get_TickCount;
 
 void dk_soft_timer_init(getSysTickCount_t fun) {
@@ -90,96 +707,701 @@ void dk_soft_timer_init(getSysTickCount_t fun) {
     vListInitialise( &xActiveTimerList2 );
     pxCurrentTimerList = &xActiveTimerList1;
     pxOverflowTimerList = &xActiveTimerList2;
-}
 
-static void prvSwitchTimerLists( void )
-{
-    TickType_t xNextExpireTime;
-    List_t * pxTemp;
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+    {
+        UBaseType_t x;
 
-    /* The tick count has overflowed.  The timer lists must be switched.
-     * If there are any timers still referenced from the current timer list
-     * then they must have expired and should be processed before the lists
-     * are switched. */
-    while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE ) {
-        xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+        for( x = 0; x < ( UBaseType_t ) configTIMER_PRIORITY_CLASSES; x++ ) {
+            vListInitialise( &( xDueTimerLists[ x ] ) );
+        }
+    }
+    #endif /* configUSE_TIMER_PRIORITY_CLASSES */
 
-        /* Process the expired timer.  For auto-reload timers, be careful to
-         * process only expirations that occur on the current list.  Further
-         * expirations must wait until after the lists are switched. */
-        prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+    #if ( configTIMER_POOL_SIZE > 0 )
+    {
+        UBaseType_t x;
+
+        portTIMER_POOL_PLACE( xTimerPool, sizeof( xTimerPool ) );
+        vListInitialise( &xFreeTimerList );
+
+        for( x = 0; x < ( UBaseType_t ) configTIMER_POOL_SIZE; x++ ) {
+            /* Generation 0 is never used so a reference is never 0. */
+            xTimerPoolGeneration[ x ] = 1U;
+            vListInitialiseItem( &( xTimerPool[ x ].xTimerListItem ) );
+            listSET_LIST_ITEM_OWNER( &( xTimerPool[ x ].xTimerListItem ), &( xTimerPool[ x ] ) );
+            vListInsertEnd( &xFreeTimerList, &( xTimerPool[ x ].xTimerListItem ) );
+        }
     }
+    #endif /* configTIMER_POOL_SIZE */
 
-    pxTemp = pxCurrentTimerList;
-    pxCurrentTimerList = pxOverflowTimerList;
-    pxOverflowTimerList = pxTemp;
-}
+    #if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+    {
+        uint32_t x;
 
-static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) {
-    TickType_t xTimeNow;
-    static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
+        portTIMER_POOL_PLACE( xCompactTimers, sizeof( xCompactTimers ) );
+        portTIMER_POOL_PLACE( ulCompactHeap, sizeof( ulCompactHeap ) );
 
-    xTimeNow = sys_get_TickCount();
+        for( x = 0; x < ( uint32_t ) configTIMER_COMPACT_POOL_SIZE; x++ ) {
+            xCompactTimers[ x ].usGeneration = 0U;
+            xCompactTimers[ x ].ulLink = ( ( x + 1U ) < ( uint32_t ) configTIMER_COMPACT_POOL_SIZE ) ? ( x + 1U ) : tmrCOMPACT_NO_INDEX;
+            xCompactTimers[ x ].xExpiryTime = 1U;
+        }
 
-    if( xTimeNow < xLastTime ) {
-        prvSwitchTimerLists();
-        *pxTimerListsWereSwitched = pdTRUE;
+        ulCompactFreeHead = 0U;
+        ulCompactHeapCount = 0U;
+        uxCompactCallbackCount = 0U;
     }
-    else {
-        *pxTimerListsWereSwitched = pdFALSE;
+    #endif /* configTIMER_COMPACT_POOL_SIZE */
+
+    #if ( configTIMER_QUEUE_LENGTH > 0 )
+    {
+        uint32_t x;
+
+        ulQueueHead = 0U;
+        ulQueueTail = 0U;
+
+        for( x = 0; x < ( uint32_t ) configTIMER_QUEUE_LENGTH; x++ ) {
+            xTimerQueue[ x ].ulSequence = x;
+        }
     }
+    #endif /* configTIMER_QUEUE_LENGTH */
 
-    xLastTime = xTimeNow;
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        uxPeriodGroupMembers = 0U;
+    #endif
+}
 
-    return xTimeNow;
+#if ( configUSE_TIMER_TRACE == 1 )
+
+static uint32_t prvTraceTimerId( const Timer_t * const pxTimer ) {
+    #if ( configTIMER_POOL_SIZE > 0 )
+    {
+        if( ( pxTimer >= &( xTimerPool[ 0 ] ) ) && ( pxTimer < &( xTimerPool[ configTIMER_POOL_SIZE ] ) ) ) {
+            return xTimerGetRef( ( TimerHandle_t ) pxTimer );
+        }
+    }
+    #endif /* configTIMER_POOL_SIZE */
+
+    return ( uint32_t ) ( uintptr_t ) pxTimer;
 }
 
-static void prvInitialiseNewTimer( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-                                   const TickType_t xTimerPeriodInTicks,
-                                   const UBaseType_t uxAutoReload,
-                                   void * const pvTimerID,
-                                   TimerCallbackFunction_t pxCallbackFunction,
-                                   Timer_t * pxNewTimer )
+static void prvTraceRecord( uint16_t usEvent,
+                            uint32_t ulTimer,
+                            uint32_t ulValue )
 {
-    /* 0 is not a valid value for xTimerPeriodInTicks. */
-    configASSERT( ( xTimerPeriodInTicks > 0 ) );
-
-    /* Initialise the timer structure members using the function
-     * parameters. */
-    pxNewTimer->pcTimerName = pcTimerName;
-    pxNewTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
-    pxNewTimer->pvTimerID = pvTimerID;
-    pxNewTimer->pxCallbackFunction = pxCallbackFunction;
-    vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
+    const uint32_t ulIndex = portATOMIC_FETCH_ADD_U32( &ulTraceWriteIndex, 1U );
+    TimerTraceRecord_t * const pxRecord = &( xTraceBuffer[ ulIndex & ( configTIMER_TRACE_BUFFER_LENGTH - 1U ) ] );
 
-    if( uxAutoReload != pdFALSE ) {
-        pxNewTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
-    }
+    pxRecord->ulTimestamp = portGET_RUN_TIME_COUNTER_VALUE();
+    pxRecord->ulTimer = ulTimer;
+    pxRecord->ulValue = ulValue;
+    pxRecord->usEvent = usEvent;
+    pxRecord->usSequence = ( uint16_t ) ulIndex;
 }
 
-static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
-                                                  const TickType_t xNextExpiryTime,
-                                                  const TickType_t xTimeNow,
-                                                  const TickType_t xCommandTime )
+#endif /* configUSE_TIMER_TRACE */
+
+static TickType_t prvCallTimerCallback( Timer_t * const pxTimer )
 {
-    BaseType_t xProcessTimerNow = pdFALSE;
+    TickType_t xNextDelay = ( TickType_t ) 0U;
 
-    listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
-    listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+    #if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+        const BaseType_t xWasCollecting = xBatchCollecting;
 
-    if( xNextExpiryTime <= xTimeNow ) {
-        /* Has the expiry time elapsed between the command to start/reset a
-         * timer was issued, and the time the command was processed? */
-        if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) { /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-            /* The time between a command being issued and the command being
-             * processed actually exceeds the timers period.  */
-            xProcessTimerNow = pdTRUE;
+        if( pxTimer->pxCallbackFunction == NULL ) {
+            TimerHandle_t xTimer = ( TimerHandle_t ) pxTimer;
+
+            configASSERT( pxBatchCallback );
+
+            if( xWasCollecting == pdFALSE ) {
+                if( pxBatchCallback != NULL ) {
+                    pxBatchCallback( &xTimer, 1U );
+                }
+            }
+            else {
+                if( uxBatchCount == ( UBaseType_t ) configTIMER_BATCH_SIZE ) {
+                    prvBatchFlush();
+                }
+
+                xBatchTimers[ uxBatchCount++ ] = xTimer;
+            }
+
+            return xNextDelay;
         }
-        else {
-            vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+
+        /* Deliver what was collected first, so expiries stay in order and
+         * the callback cannot delete a timer still waiting in the batch. */
+        prvBatchFlush();
+        xBatchCollecting = pdFALSE;
+    #endif /* configUSE_TIMER_BATCH_CALLBACK */
+
+    #if ( configUSE_TIMER_TRACE == 1 )
+        /* Everything needed for the record is taken before the call as the
+         * callback may delete the timer. */
+        const uint32_t ulTimer = prvTraceTimerId( pxTimer );
+    #endif
+
+    #if ( configUSE_TIMER_TRACE == 1 ) || ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        const uint32_t ulStart = portGET_RUN_TIME_COUNTER_VALUE();
+        uint32_t ulDuration;
+    #endif
+
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        const char * const pcTimerName = pxTimer->pcTimerName;
+        CallbackFrame_t xFrame;
+
+        xFrame.pxTimer = pxTimer;
+        xFrame.pxOuter = pxCallbackFrames;
+        pxCallbackFrames = &xFrame;
+    #endif
+
+    #if ( configUSE_TIMER_RESCHEDULE == 1 )
+        if( ( pxTimer->ucStatus & tmrSTATUS_IS_RESCHEDULING ) != 0 ) {
+            xNextDelay = ( ( TimerRescheduleFunction_t ) ( void ( * )( void ) ) pxTimer->pxCallbackFunction )( ( TimerHandle_t ) pxTimer );
         }
+        else
+    #endif
+    {
+        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
     }
-    else {
+
+    #if ( configUSE_TIMER_TRACE == 1 ) || ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        ulDuration = portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+    #endif
+
+    #if ( configUSE_TIMER_TRACE == 1 )
+        prvTraceRecord( tmrTRACE_EVENT_CALLBACK, ulTimer, ulDuration );
+    #endif
+
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+    {
+        /* NULL if the callback deleted the timer. */
+        Timer_t * const pxStillValid = xFrame.pxTimer;
+
+        pxCallbackFrames = xFrame.pxOuter;
+
+        if( pxStillValid != NULL ) {
+            if( ulDuration > pxStillValid->ulCallbackMaxTime ) {
+                pxStillValid->ulCallbackMaxTime = ulDuration;
+            }
+
+            pxStillValid->ullCallbackTotalTime += ulDuration;
+        }
+
+        if( ulDuration > ( uint32_t ) configTIMER_CALLBACK_BUDGET ) {
+            vApplicationTimerOverrunHook( ( TimerHandle_t ) pxStillValid, pcTimerName, ulDuration );
+        }
+    }
+    #endif /* configUSE_TIMER_CALLBACK_BUDGET */
+
+    #if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+        xBatchCollecting = xWasCollecting;
+    #endif
+
+    return xNextDelay;
+}
+
+#if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+
+static void prvBatchFlush( void )
+{
+    const UBaseType_t uxCount = uxBatchCount;
+
+    if( uxCount != 0U ) {
+        /* Expiries caused by the batch callback itself are delivered
+         * directly rather than into the array being read. */
+        uxBatchCount = 0U;
+        xBatchCollecting = pdFALSE;
+        pxBatchCallback( xBatchTimers, uxCount );
+        xBatchCollecting = pdTRUE;
+    }
+}
+
+void vTimerSetBatchCallback( TimerBatchCallbackFunction_t pxNewBatchCallback )
+{
+    pxBatchCallback = pxNewBatchCallback;
+}
+
+#endif /* configUSE_TIMER_BATCH_CALLBACK */
+
+#if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+
+static TimerHeap_t * prvGetHeap( const List_t * const pxList ) {
+    return ( pxList == &xActiveTimerList1 ) ? &xActiveTimerHeap1 : &xActiveTimerHeap2;
+}
+
+static void prvHeapPlace( TimerHeap_t * const pxHeap,
+                          const UBaseType_t uxIndex,
+                          Timer_t * const pxTimer )
+{
+    pxHeap->ppxTimers[ uxIndex ] = pxTimer;
+    pxTimer->uxHeapIndex = uxIndex;
+}
+
+static void prvHeapSiftUp( TimerHeap_t * const pxHeap,
+                           UBaseType_t uxIndex )
+{
+    Timer_t * const pxTimer = pxHeap->ppxTimers[ uxIndex ];
+    const TickType_t xValue = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+    UBaseType_t uxParent;
+
+    while( uxIndex > 0U ) {
+        uxParent = ( uxIndex - 1U ) / 2U;
+
+        if( listGET_LIST_ITEM_VALUE( &( pxHeap->ppxTimers[ uxParent ]->xTimerListItem ) ) <= xValue ) {
+            break;
+        }
+
+        prvHeapPlace( pxHeap, uxIndex, pxHeap->ppxTimers[ uxParent ] );
+        uxIndex = uxParent;
+    }
+
+    prvHeapPlace( pxHeap, uxIndex, pxTimer );
+}
+
+static void prvHeapSiftDown( TimerHeap_t * const pxHeap,
+                             UBaseType_t uxIndex,
+                             const UBaseType_t uxCount )
+{
+    Timer_t * const pxTimer = pxHeap->ppxTimers[ uxIndex ];
+    const TickType_t xValue = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+    UBaseType_t uxChild;
+
+    for( ; ; ) {
+        uxChild = ( uxIndex * 2U ) + 1U;
+
+        if( uxChild >= uxCount ) {
+            break;
+        }
+
+        if( ( ( uxChild + 1U ) < uxCount ) &&
+            ( listGET_LIST_ITEM_VALUE( &( pxHeap->ppxTimers[ uxChild + 1U ]->xTimerListItem ) ) < listGET_LIST_ITEM_VALUE( &( pxHeap->ppxTimers[ uxChild ]->xTimerListItem ) ) ) ) {
+            uxChild++;
+        }
+
+        if( xValue <= listGET_LIST_ITEM_VALUE( &( pxHeap->ppxTimers[ uxChild ]->xTimerListItem ) ) ) {
+            break;
+        }
+
+        prvHeapPlace( pxHeap, uxIndex, pxHeap->ppxTimers[ uxChild ] );
+        uxIndex = uxChild;
+    }
+
+    prvHeapPlace( pxHeap, uxIndex, pxTimer );
+}
+
+static BaseType_t prvHeapReserve( TimerHeap_t * const pxHeap,
+                                  const UBaseType_t uxCount )
+{
+    Timer_t ** ppxTimers;
+    UBaseType_t uxCapacity;
+    UBaseType_t x;
+
+    if( uxCount <= pxHeap->uxCapacity ) {
+        return pdTRUE;
+    }
+
+    uxCapacity = ( pxHeap->uxCapacity < tmrHEAP_MIN_CAPACITY ) ? tmrHEAP_MIN_CAPACITY : pxHeap->uxCapacity;
+
+    while( uxCapacity < uxCount ) {
+        uxCapacity *= 2U;
+    }
+
+    ppxTimers = ( Timer_t ** ) pvPortMalloc( ( size_t ) uxCapacity * sizeof( Timer_t * ) );
+
+    if( ppxTimers == NULL ) {
+        return pdFALSE;
+    }
+
+    for( x = 0; x < pxHeap->uxCapacity; x++ ) {
+        ppxTimers[ x ] = pxHeap->ppxTimers[ x ];
+    }
+
+    if( pxHeap->ppxTimers != NULL ) {
+        vPortFree( pxHeap->ppxTimers );
+    }
+
+    pxHeap->ppxTimers = ppxTimers;
+    pxHeap->uxCapacity = uxCapacity;
+
+    return pdTRUE;
+}
+
+static void prvHeapRelease( TimerHeap_t * const pxHeap ) {
+    if( pxHeap->ppxTimers != NULL ) {
+        vPortFree( pxHeap->ppxTimers );
+    }
+
+    pxHeap->ppxTimers = NULL;
+    pxHeap->uxCapacity = 0U;
+}
+
+/*
+ * Move every active timer from the sorted lists into the heaps.  Walking a
+ * sorted list front to back already yields a valid heap, so no sifting is
+ * needed.  Fails, leaving the lists untouched, if the arrays cannot be
+ * allocated.
+ */
+static BaseType_t prvMoveListsToHeaps( void ) {
+    List_t * const pxLists[ 2 ] = { &xActiveTimerList1, &xActiveTimerList2 };
+    TimerHeap_t * pxHeap;
+    ListItem_t * pxItem;
+    ListItem_t * pxNext;
+    UBaseType_t uxCount;
+    UBaseType_t uxIndex;
+    UBaseType_t x;
+
+    if( ( prvHeapReserve( &xActiveTimerHeap1, listCURRENT_LIST_LENGTH( &xActiveTimerList1 ) * 2U ) == pdFALSE ) ||
+        ( prvHeapReserve( &xActiveTimerHeap2, listCURRENT_LIST_LENGTH( &xActiveTimerList2 ) * 2U ) == pdFALSE ) ) {
+        prvHeapRelease( &xActiveTimerHeap1 );
+        prvHeapRelease( &xActiveTimerHeap2 );
+        return pdFALSE;
+    }
+
+    for( x = 0; x < 2U; x++ ) {
+        pxHeap = prvGetHeap( pxLists[ x ] );
+        uxCount = listCURRENT_LIST_LENGTH( pxLists[ x ] );
+        pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxLists[ x ] );
+
+        for( uxIndex = 0; uxIndex < uxCount; uxIndex++ ) {
+            pxNext = ( ListItem_t * ) listGET_NEXT( pxItem );
+            prvHeapPlace( pxHeap, uxIndex, ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
+            pxItem = pxNext;
+        }
+
+        /* Reset the links but keep the count, the timers still belong to
+         * this list. */
+        vListInitialise( pxLists[ x ] );
+        pxLists[ x ]->uxNumberOfItems = uxCount;
+    }
+
+    xHeapsInUse = pdTRUE;
+    xLowCountSeen = pdFALSE;
+
+    return pdTRUE;
+}
+
+/*
+ * Move every active timer from the heaps back into the sorted lists, then
+ * free the heap arrays.  Never fails as no memory is needed.
+ */
+static void prvMoveHeapsToLists( void ) {
+    List_t * const pxLists[ 2 ] = { &xActiveTimerList1, &xActiveTimerList2 };
+    TimerHeap_t * pxHeap;
+    Timer_t * pxTimer;
+    UBaseType_t uxCount;
+    UBaseType_t x;
+
+    for( x = 0; x < 2U; x++ ) {
+        pxHeap = prvGetHeap( pxLists[ x ] );
+        uxCount = listCURRENT_LIST_LENGTH( pxLists[ x ] );
+        vListInitialise( pxLists[ x ] );
+
+        /* Popping the heap yields the timers in expiry order, so appending
+         * each one keeps the list sorted. */
+        while( uxCount > 0U ) {
+            pxTimer = pxHeap->ppxTimers[ 0 ];
+            uxCount--;
+
+            if( uxCount > 0U ) {
+                prvHeapPlace( pxHeap, 0U, pxHeap->ppxTimers[ uxCount ] );
+                prvHeapSiftDown( pxHeap, 0U, uxCount );
+            }
+
+            vListInsertEnd( pxLists[ x ], &( pxTimer->xTimerListItem ) );
+        }
+
+        prvHeapRelease( pxHeap );
+    }
+
+    xHeapsInUse = pdFALSE;
+}
+
+/*
+ * Switch structure if the number of active timers calls for it.
+ */
+static void prvCheckBackend( const TickType_t xTimeNow ) {
+    const UBaseType_t uxCount = listCURRENT_LIST_LENGTH( &xActiveTimerList1 ) + listCURRENT_LIST_LENGTH( &xActiveTimerList2 );
+
+    if( uxBackend != tmrBACKEND_ADAPTIVE ) {
+        return;
+    }
+
+    if( xHeapsInUse == pdFALSE ) {
+        if( uxCount > ( UBaseType_t ) configTIMER_ADAPTIVE_HEAP_THRESHOLD ) {
+            /* Stay on the lists if the heaps cannot be allocated. */
+            ( void ) prvMoveListsToHeaps();
+        }
+    }
+    else if( uxCount >= ( UBaseType_t ) configTIMER_ADAPTIVE_LIST_THRESHOLD ) {
+        xLowCountSeen = pdFALSE;
+    }
+    else if( xLowCountSeen == pdFALSE ) {
+        xLowCountSeen = pdTRUE;
+        xLowCountSince = xTimeNow;
+    }
+    else if( ( TickType_t ) ( xTimeNow - xLowCountSince ) >= ( TickType_t ) configTIMER_ADAPTIVE_SETTLE_TICKS ) {
+        prvMoveHeapsToLists();
+    }
+}
+
+#endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+static void prvActiveListInsert( List_t * const pxList,
+                                 Timer_t * const pxTimer )
+{
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+    {
+        if( xHeapsInUse == pdFALSE ) {
+            /* The same test as prvCheckBackend(), counting pxTimer. */
+            if( ( uxBackend == tmrBACKEND_ADAPTIVE ) &&
+                ( ( listCURRENT_LIST_LENGTH( &xActiveTimerList1 ) + listCURRENT_LIST_LENGTH( &xActiveTimerList2 ) + 1U ) > ( UBaseType_t ) configTIMER_ADAPTIVE_HEAP_THRESHOLD ) ) {
+                ( void ) prvMoveListsToHeaps();
+            }
+        }
+
+        if( xHeapsInUse != pdFALSE ) {
+            TimerHeap_t * const pxHeap = prvGetHeap( pxList );
+            const UBaseType_t uxCount = listCURRENT_LIST_LENGTH( pxList );
+
+            if( prvHeapReserve( pxHeap, uxCount + 1U ) != pdFALSE ) {
+                prvHeapPlace( pxHeap, uxCount, pxTimer );
+                prvHeapSiftUp( pxHeap, uxCount );
+                pxTimer->xTimerListItem.pxContainer = pxList;
+                ( pxList->uxNumberOfItems )++;
+                return;
+            }
+
+            /* Out of memory, fall back to the lists, which never need to
+             * allocate. */
+            prvMoveHeapsToLists();
+        }
+    }
+    #endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+    vListInsert( pxList, &( pxTimer->xTimerListItem ) );
+}
+
+static void prvActiveListRemove( Timer_t * const pxTimer ) {
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+    {
+        /* A due timer waiting for its callback is in a plain list. */
+        const BaseType_t xInHeap = tmrIS_IN_ACTIVE_LIST( pxTimer ) ? xHeapsInUse : pdFALSE;
+
+        if( xInHeap != pdFALSE ) {
+            List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+            TimerHeap_t * const pxHeap = prvGetHeap( pxList );
+            const UBaseType_t uxIndex = pxTimer->uxHeapIndex;
+            const UBaseType_t uxLast = listCURRENT_LIST_LENGTH( pxList ) - 1U;
+
+            ( pxList->uxNumberOfItems )--;
+            pxTimer->xTimerListItem.pxContainer = NULL;
+
+            if( uxIndex != uxLast ) {
+                /* Fill the hole with the last timer, which may need to move
+                 * either way. */
+                Timer_t * const pxMoved = pxHeap->ppxTimers[ uxLast ];
+
+                prvHeapPlace( pxHeap, uxIndex, pxMoved );
+                prvHeapSiftDown( pxHeap, uxIndex, uxLast );
+
+                if( pxMoved->uxHeapIndex == uxIndex ) {
+                    prvHeapSiftUp( pxHeap, uxIndex );
+                }
+            }
+
+            return;
+        }
+    }
+    #endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+}
+
+static Timer_t * prvActiveListHead( List_t * const pxList ) {
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+    {
+        if( xHeapsInUse != pdFALSE ) {
+            return prvGetHeap( pxList )->ppxTimers[ 0 ];
+        }
+    }
+    #endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+    return ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+}
+
+#if ( configUSE_TIMER_USDT == 1 )
+
+static UBaseType_t prvProbeWalkLength( const Timer_t * const pxTimer ) {
+    const List_t * const pxList = pxTimer->xTimerListItem.pxContainer;
+    const ListItem_t * pxItem;
+    UBaseType_t uxWalk = 0U;
+
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+        if( xHeapsInUse != pdFALSE ) {
+            UBaseType_t uxFrom = listCURRENT_LIST_LENGTH( pxList );
+            UBaseType_t uxTo = pxTimer->uxHeapIndex + 1U;
+
+            /* The timer was placed last and sifted up one level per step. */
+            while( uxFrom > uxTo ) {
+                uxFrom /= 2U;
+                uxWalk++;
+            }
+
+            return uxWalk;
+        }
+    #endif
+
+    /* vListInsert() steps over every item that does not expire later, which
+     * are exactly the items before the new one. */
+    for( pxItem = pxTimer->xTimerListItem.pxPrevious; pxItem != listGET_END_MARKER( pxList ); pxItem = pxItem->pxPrevious ) {
+        uxWalk++;
+    }
+
+    return uxWalk;
+}
+
+#endif /* configUSE_TIMER_USDT */
+
+static void prvSwitchTimerLists( void )
+{
+    TickType_t xNextExpireTime;
+    List_t * pxTemp;
+    UBaseType_t uxExpired = 0U;
+
+    /* The tick count has overflowed.  The timer lists must be switched.
+     * If there are any timers still referenced from the current timer list
+     * then they must have expired and should be processed before the lists
+     * are switched. */
+    while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE ) {
+        xNextExpireTime = listGET_LIST_ITEM_VALUE( &( prvActiveListHead( pxCurrentTimerList )->xTimerListItem ) );
+
+        /* Process the expired timer.  For auto-reload timers, be careful to
+         * process only expirations that occur on the current list.  Further
+         * expirations must wait until after the lists are switched. */
+        prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+        uxExpired++;
+    }
+
+    pxTemp = pxCurrentTimerList;
+    pxCurrentTimerList = pxOverflowTimerList;
+    pxOverflowTimerList = pxTemp;
+
+    tmrPROBE2( switch_lists, uxExpired, listCURRENT_LIST_LENGTH( pxCurrentTimerList ) );
+    ( void ) uxExpired;
+}
+
+static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched ) {
+    TickType_t xTimeNow;
+
+    xTimeNow = sys_get_TickCount();
+
+    if( xTimeNow < xLastTime ) {
+        prvSwitchTimerLists();
+        *pxTimerListsWereSwitched = pdTRUE;
+    }
+    else {
+        *pxTimerListsWereSwitched = pdFALSE;
+    }
+
+    xLastTime = xTimeNow;
+
+    return xTimeNow;
+}
+
+static void prvInitialiseNewTimer( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                   const TickType_t xTimerPeriodInTicks,
+                                   const UBaseType_t uxAutoReload,
+                                   void * const pvTimerID,
+                                   TimerCallbackFunction_t pxCallbackFunction,
+                                   Timer_t * pxNewTimer )
+{
+    /* 0 is not a valid value for xTimerPeriodInTicks. */
+    configASSERT( ( xTimerPeriodInTicks > 0 ) );
+
+    /* Initialise the timer structure members using the function
+     * parameters. */
+    pxNewTimer->pcTimerName = pcTimerName;
+    pxNewTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
+    pxNewTimer->pvTimerID = pvTimerID;
+    pxNewTimer->pxCallbackFunction = pxCallbackFunction;
+    vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
+    tmrRECORD_PERIOD( xTimerPeriodInTicks );
+
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        pxNewTimer->pxPeriodGroup = NULL;
+    #endif
+
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        pxNewTimer->ulSequence = 0U;
+    #endif
+
+    #if ( configUSE_TIMER_BACKOFF == 1 )
+        pxNewTimer->pxBackoffPolicy = NULL;
+        pxNewTimer->xBackoffDelay = 0U;
+    #endif
+
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        pxNewTimer->ucPriorityClass = 0U;
+    #endif
+
+    #if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+        /* Numbered whether or not a recording is running, a recording may
+         * start while the timer exists. */
+        if( ++ulWorkloadLastId == 0U ) {
+            ulWorkloadLastId = 1U;
+        }
+
+        pxNewTimer->ulWorkloadId = ulWorkloadLastId;
+    #endif
+
+    #if ( configUSE_TIMER_GROUPS == 1 )
+        vListInitialiseItem( &( pxNewTimer->xGroupListItem ) );
+        listSET_LIST_ITEM_OWNER( &( pxNewTimer->xGroupListItem ), pxNewTimer );
+    #endif
+
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        pxNewTimer->ulCallbackMaxTime = 0U;
+        pxNewTimer->ullCallbackTotalTime = 0U;
+    #endif
+
+    if( uxAutoReload != pdFALSE ) {
+        pxNewTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
+    }
+}
+
+static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+                                                  const TickType_t xNextExpiryTime,
+                                                  const TickType_t xTimeNow,
+                                                  const TickType_t xCommandTime )
+{
+    BaseType_t xProcessTimerNow = pdFALSE;
+
+    /* Any deadline recorded by a lazy reset is superseded.  The timer is
+     * marked active together with its new expiry time, so another thread
+     * never sees it active with a stale one. */
+    tmrBEGIN_STATE_WRITE( pxTimer );
+    tmrCLEAR_STATUS( pxTimer, tmrSTATUS_RESET_PENDING );
+    tmrSET_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+
+    listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+    tmrEND_STATE_WRITE( pxTimer );
+    listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+    if( xNextExpiryTime <= xTimeNow ) {
+        /* Has the expiry time elapsed between the command to start/reset a
+         * timer was issued, and the time the command was processed? */
+        if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) { /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            /* The time between a command being issued and the command being
+             * processed actually exceeds the timers period.  */
+            xProcessTimerNow = pdTRUE;
+        }
+        else {
+            prvActiveListInsert( pxOverflowTimerList, pxTimer );
+        }
+    }
+    else {
         if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) ) {
             /* If, since the command was issued, the tick count has overflowed
              * but the expiry time has not, then the timer must have already passed
@@ -187,10 +1409,16 @@ static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
             xProcessTimerNow = pdTRUE;
         }
         else {
-            vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+            prvActiveListInsert( pxCurrentTimerList, pxTimer );
         }
     }
 
+    #if ( configUSE_TIMER_USDT == 1 )
+        if( ( xProcessTimerNow == pdFALSE ) && tmrPROBE_ENABLED( insert ) ) {
+            tmrPROBE3( insert, pxTimer, xNextExpiryTime, prvProbeWalkLength( pxTimer ) );
+        }
+    #endif
+
     return xProcessTimerNow;
 }
 
@@ -204,252 +1432,2658 @@ static void prvReloadTimer( Timer_t * const pxTimer,
     while( prvInsertTimerInActiveList( pxTimer, ( xExpiredTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xExpiredTime ) != pdFALSE ) {
         /* Advance the expiry time. */
         xExpiredTime += pxTimer->xTimerPeriodInTicks;
+        traceTIMER_EXPIRED( pxTimer, xExpiredTime );
+        tmrPROBE2( reload_catchup, pxTimer, xExpiredTime );
+        tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_EXPIRED, pxTimer, xExpiredTime, 0U );
+
+        /* Call the timer callback. */
+        ( void ) prvCallTimerCallback( pxTimer );
+    }
+}
+
+#if ( configUSE_TIMER_BACKOFF == 1 )
+
+static TickType_t prvBackoffJitter( const TimerBackoffPolicy_t * const pxPolicy,
+                                    TickType_t xDelay )
+{
+    uint32_t ulPercent = pxPolicy->ucJitterPercent;
+    TickType_t xJitter;
+
+    configASSERT( ulPercent <= 100U );
+
+    if( ulPercent > 100U ) {
+        /* More would take the delay below 0. */
+        ulPercent = 100U;
+    }
+
+    if( ulPercent != 0U ) {
+        ulBackoffRandom ^= ulBackoffRandom << 13;
+        ulBackoffRandom ^= ulBackoffRandom >> 17;
+        ulBackoffRandom ^= ulBackoffRandom << 5;
+
+        xJitter = ( TickType_t ) ( ( ( uint64_t ) xDelay * ulPercent ) / 100U );
+        xDelay -= ulBackoffRandom % ( xJitter + 1U );
+    }
+
+    /* 0 is not a valid period. */
+    return ( xDelay != 0U ) ? xDelay : ( TickType_t ) 1U;
+}
+
+static void prvBackoffRestart( Timer_t * const pxTimer )
+{
+    const TimerBackoffPolicy_t * const pxPolicy = pxTimer->pxBackoffPolicy;
+
+    pxTimer->xBackoffDelay = ( pxPolicy->xBaseTicks < pxPolicy->xCapTicks ) ? pxPolicy->xBaseTicks : pxPolicy->xCapTicks;
+    tmrSTORE_PERIOD( pxTimer, prvBackoffJitter( pxPolicy, pxTimer->xBackoffDelay ) );
+}
+
+static void prvBackoffTimer( Timer_t * const pxTimer,
+                             const TickType_t xTimeNow )
+{
+    const TimerBackoffPolicy_t * const pxPolicy = pxTimer->pxBackoffPolicy;
+    uint64_t ullDelay = ( ( uint64_t ) pxTimer->xBackoffDelay * pxPolicy->usMultiplier ) >> 8;
+    TickType_t xDelay;
+
+    if( ullDelay > ( uint64_t ) pxPolicy->xCapTicks ) {
+        ullDelay = pxPolicy->xCapTicks;
+    }
+
+    /* The growth works on the delay before jitter, so the jitter of one
+     * retry is not carried into the next. */
+    pxTimer->xBackoffDelay = ( TickType_t ) ullDelay;
+    xDelay = prvBackoffJitter( pxPolicy, pxTimer->xBackoffDelay );
+
+    /* Relative to the tick the retry is made at rather than the missed
+     * deadline, a late retry is not followed by a burst of catch-up ones.
+     * As the delay is never 0 the timer always goes into a list. */
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_CHANGE_PERIOD, pxTimer, xDelay, 0U );
+    tmrSTORE_PERIOD( pxTimer, xDelay );
+    ( void ) prvInsertTimerInActiveList( pxTimer, xTimeNow + xDelay, xTimeNow, xTimeNow );
+}
+
+TimerHandle_t xTimerCreateBackoff( const char * const pcTimerName,
+                                   const TimerBackoffPolicy_t * pxPolicy,
+                                   void * const pvTimerID,
+                                   TimerCallbackFunction_t pxCallbackFunction ) {
+    Timer_t * pxNewTimer;
+
+    configASSERT( pxPolicy );
+    configASSERT( pxPolicy->ucJitterPercent <= 100U );
+
+    pxNewTimer = xTimerCreate( pcTimerName, pxPolicy->xBaseTicks, pdFALSE, pvTimerID, pxCallbackFunction );
+
+    if( pxNewTimer != NULL ) {
+        pxNewTimer->pxBackoffPolicy = pxPolicy;
+        prvBackoffRestart( pxNewTimer );
+    }
+
+    return pxNewTimer;
+}
+/*-----------------------------------------------------------*/
+
+TimerHandle_t xTimerCreateBackoffStatic( const char * const pcTimerName,
+                                         const TimerBackoffPolicy_t * pxPolicy,
+                                         void * const pvTimerID,
+                                         TimerCallbackFunction_t pxCallbackFunction,
+                                         StaticTimer_t * pxTimerBuffer ) {
+    Timer_t * pxNewTimer;
+
+    configASSERT( pxPolicy );
+    configASSERT( pxPolicy->ucJitterPercent <= 100U );
+
+    pxNewTimer = xTimerCreateStatic( pcTimerName, pxPolicy->xBaseTicks, pdFALSE, pvTimerID, pxCallbackFunction, pxTimerBuffer );
+
+    if( pxNewTimer != NULL ) {
+        pxNewTimer->pxBackoffPolicy = pxPolicy;
+        prvBackoffRestart( pxNewTimer );
+    }
+
+    return pxNewTimer;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerSetBackoffSeed( uint32_t ulSeed ) {
+    /* xorshift never leaves 0. */
+    ulBackoffRandom = ( ulSeed != 0U ) ? ulSeed : tmrBACKOFF_DEFAULT_SEED;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_BACKOFF */
+
+static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) {
+    TickType_t xNextExpireTime;
+
+    /* Timers are listed in expiry time order, with the head of the list
+     * referencing the task that will expire first.  Obtain the time at which
+     * the timer with the nearest expiry time will expire.  If there are no
+     * active timers then just set the next expire time to 0.  That will cause
+     * this task to unblock when the tick count overflows, at which point the
+     * timer lists will be switched and the next expiry time can be
+     * re-assessed.  */
+    *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+    if( *pxListWasEmpty == pdFALSE ) {
+        xNextExpireTime = listGET_LIST_ITEM_VALUE( &( prvActiveListHead( pxCurrentTimerList )->xTimerListItem ) );
+    }
+    else {
+        /* Ensure the task unblocks when the tick count rolls over. */
+        xNextExpireTime = ( TickType_t ) 0U;
+    }
+
+    return xNextExpireTime;
+}
+
+static void prvProcessExpiredTimer( TickType_t xNextExpireTime, const TickType_t xTimeNow ) {
+    Timer_t * const pxTimer = prvActiveListHead( pxCurrentTimerList );
+
+    /* Remove the timer from the list of active timers.  A check has already
+     * been performed to ensure the list is not empty. */
+    prvActiveListRemove( pxTimer );
+
+    #if ( configUSE_TIMER_LAZY_RESET == 1 )
+    {
+        if( ( pxTimer->ucStatus & tmrSTATUS_RESET_PENDING ) != 0 ) {
+            /* The timer was reset after it was inserted.  Move it to the
+             * recorded deadline, as if the reset had been a start command
+             * issued at the time of the last reset. */
+            xNextExpireTime = pxTimer->xLazyExpiryTime;
+
+            if( prvInsertTimerInActiveList( pxTimer, xNextExpireTime, xTimeNow, xNextExpireTime - pxTimer->xTimerPeriodInTicks ) == pdFALSE ) {
+                return;
+            }
+
+            /* The recorded deadline has passed as well, so the timer
+             * expires now. */
+        }
+    }
+    #endif /* configUSE_TIMER_LAZY_RESET */
+
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        /* The list item still holds the expiry time. */
+        vListInsertEnd( &( xDueTimerLists[ pxTimer->ucPriorityClass ] ), &( pxTimer->xTimerListItem ) );
+        ( void ) xNextExpireTime;
+        ( void ) xTimeNow;
+    #else
+        prvExpireTimer( pxTimer, xNextExpireTime, xTimeNow );
+    #endif
+}
+
+static void prvExpireTimer( Timer_t * const pxTimer,
+                            const TickType_t xNextExpireTime,
+                            const TickType_t xTimeNow ) {
+    traceTIMER_EXPIRED( pxTimer, xNextExpireTime );
+    tmrPROBE3( expired, pxTimer, xNextExpireTime, xTimeNow );
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_EXPIRED, pxTimer, xNextExpireTime, 0U );
+
+    /* If the timer is an auto-reload timer then calculate the next
+     * expiry time and re-insert the timer in the list of active timers. */
+    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 ) {
+        prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+    }
+    #if ( configUSE_TIMER_BACKOFF == 1 )
+        else if( pxTimer->pxBackoffPolicy != NULL ) {
+            prvBackoffTimer( pxTimer, xTimeNow );
+        }
+    #endif
+    else {
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+    }
+
+    /* Call the timer callback. */
+    #if ( configUSE_TIMER_RESCHEDULE == 1 )
+    {
+        const TickType_t xNextDelay = prvCallTimerCallback( pxTimer );
+
+        /* The timer is only accessed again if the callback asked for it to
+         * be rescheduled, in which case it has not been deleted.  It is
+         * rearmed from the tick it was processed at, which the callback
+         * cannot have changed, so no clock read is needed. */
+        if( ( xNextDelay != tmrRESCHEDULE_STOP ) && ( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0 ) ) {
+            tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_CHANGE_PERIOD, pxTimer, xNextDelay, 0U );
+            tmrRECORD_PERIOD( xNextDelay );
+            tmrSTORE_PERIOD( pxTimer, xNextDelay );
+            ( void ) prvInsertTimerInActiveList( pxTimer, xTimeNow + xNextDelay, xTimeNow, xTimeNow );
+        }
+    }
+    #else
+        ( void ) prvCallTimerCallback( pxTimer );
+    #endif /* configUSE_TIMER_RESCHEDULE */
+}
+
+#if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+
+static void prvDispatchDueTimers( const TickType_t xTimeNow ) {
+    UBaseType_t uxClass = ( UBaseType_t ) configTIMER_PRIORITY_CLASSES;
+    UBaseType_t uxDispatched = 0U;
+    List_t * pxList;
+    Timer_t * pxTimer;
+
+    while( uxClass > 0U ) {
+        uxClass--;
+        pxList = &( xDueTimerLists[ uxClass ] );
+
+        /* A callback may stop, delete or restart any timer still queued,
+         * which takes it out of its list, so the head is read again every
+         * time. */
+        while( ( listLIST_IS_EMPTY( pxList ) == pdFALSE ) &&
+               ( ( uxClassBudget[ uxClass ] == 0U ) || ( uxDispatched < uxClassBudget[ uxClass ] ) ) ) {
+            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxList );
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            uxDispatched++;
+            prvExpireTimer( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ), xTimeNow );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vTimerSetPriorityClass( TimerHandle_t xTimer,
+                             UBaseType_t uxClass ) {
+    Timer_t * const pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    configASSERT( uxClass < ( UBaseType_t ) configTIMER_PRIORITY_CLASSES );
+
+    /* A timer already queued keeps its place, the class applies from its
+     * next expiry. */
+    pxTimer->ucPriorityClass = ( uint8_t ) uxClass;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerGetPriorityClass( TimerHandle_t xTimer ) {
+    Timer_t * const pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    return ( UBaseType_t ) pxTimer->ucPriorityClass;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerSetClassBudget( UBaseType_t uxClass,
+                           UBaseType_t uxMaxCallbacks ) {
+    configASSERT( uxClass < ( UBaseType_t ) configTIMER_PRIORITY_CLASSES );
+    uxClassBudget[ uxClass ] = uxMaxCallbacks;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_PRIORITY_CLASSES */
+
+static TickType_t prvGetTimerExpiryTime( const Timer_t * pxTimer ) {
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        if( pxTimer->pxPeriodGroup != NULL ) {
+            /* Members expire with their group. */
+            pxTimer = &( pxTimer->pxPeriodGroup->xAnchor );
+        }
+    #endif
+
+    #if ( configUSE_TIMER_LAZY_RESET == 1 )
+        if( ( tmrLOAD_STATUS( pxTimer ) & tmrSTATUS_RESET_PENDING ) != 0 ) {
+            return pxTimer->xLazyExpiryTime;
+        }
+    #endif
+
+    return listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+
+static uint32_t prvReadSequenceBegin( const Timer_t * const pxTimer )
+{
+    uint32_t ulSequence;
+
+    /* Wait for a write section in progress to end.  Sections are a few
+     * stores long and never span a callback. */
+    do {
+        ulSequence = portATOMIC_LOAD_ACQUIRE_U32( &( pxTimer->ulSequence ) );
+    } while( ( ulSequence & 1U ) != 0U );
+
+    return ulSequence;
+}
+
+#endif /* configUSE_TIMER_CONCURRENT_READS */
+/*-----------------------------------------------------------*/
+
+TickType_t xTimerGetPeriod( TimerHandle_t xTimer )
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    return tmrLOAD_PERIOD( pxTimer );
+}
+/*-----------------------------------------------------------*/
+
+void vTimerSetReloadMode( TimerHandle_t xTimer,
+                          const UBaseType_t uxAutoReload )
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    if( uxAutoReload != pdFALSE )
+    {
+        tmrSET_STATUS( pxTimer, tmrSTATUS_IS_AUTORELOAD );
+    }
+    else
+    {
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_AUTORELOAD );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer )
+{
+    Timer_t * pxTimer = xTimer;
+    UBaseType_t uxReturn;
+
+    configASSERT( xTimer );
+    taskENTER_CRITICAL();
+    {
+        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) == 0 )
+        {
+            /* Not an auto-reload timer. */
+            uxReturn = ( UBaseType_t ) pdFALSE;
+        }
+        else
+        {
+            /* Is an auto-reload timer. */
+            uxReturn = ( UBaseType_t ) pdTRUE;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIMER_LAZY_RESET == 1 )
+
+void vTimerSetLazyReset( TimerHandle_t xTimer,
+                         const UBaseType_t uxLazyReset )
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    /* A deadline already recorded is still honoured when lazy reset is
+     * turned off, tmrSTATUS_RESET_PENDING is only cleared by reinserting the
+     * timer. */
+    if( uxLazyReset != pdFALSE ) {
+        tmrSET_STATUS( pxTimer, tmrSTATUS_IS_LAZY_RESET );
+    }
+    else {
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_LAZY_RESET );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_LAZY_RESET */
+
+TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer )
+{
+    Timer_t * pxTimer = xTimer;
+    TickType_t xReturn;
+
+    configASSERT( xTimer );
+
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+    {
+        uint32_t ulSequence;
+        BaseType_t xRetry;
+
+        #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+            Timer_t * pxAnchor;
+            uint32_t ulAnchorSequence = 0U;
+        #endif
+
+        /* Read the expiry state again if the timer service changed it in the
+         * meantime.  For a group member the state of the group anchor must be
+         * stable as well.  Groups are never freed in this configuration, so
+         * the anchor can be read even if the group is deleted meanwhile, in
+         * which case the member's own sequence has changed. */
+        do {
+            ulSequence = prvReadSequenceBegin( pxTimer );
+
+            #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+                pxAnchor = ( pxTimer->pxPeriodGroup != NULL ) ? &( pxTimer->pxPeriodGroup->xAnchor ) : NULL;
+
+                if( pxAnchor != NULL ) {
+                    ulAnchorSequence = prvReadSequenceBegin( pxAnchor );
+                }
+            #endif
+
+            xReturn = prvGetTimerExpiryTime( pxTimer );
+
+            portATOMIC_THREAD_FENCE_ACQUIRE();
+            xRetry = ( portATOMIC_LOAD_ACQUIRE_U32( &( pxTimer->ulSequence ) ) != ulSequence ) ? pdTRUE : pdFALSE;
+
+            #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+                if( ( pxAnchor != NULL ) && ( portATOMIC_LOAD_ACQUIRE_U32( &( pxAnchor->ulSequence ) ) != ulAnchorSequence ) ) {
+                    xRetry = pdTRUE;
+                }
+            #endif
+        } while( xRetry != pdFALSE );
+    }
+    #else
+        xReturn = prvGetTimerExpiryTime( pxTimer );
+    #endif /* configUSE_TIMER_CONCURRENT_READS */
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcTimerGetName( TimerHandle_t xTimer ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    return pxTimer->pcTimerName;
+}
+
+TimerHandle_t xTimerCreate( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                    const TickType_t xTimerPeriodInTicks,
+                                    const UBaseType_t uxAutoReload,
+                                    void * const pvTimerID,
+                                    TimerCallbackFunction_t pxCallbackFunction )
+{
+    Timer_t * pxNewTimer;
+
+    #if ( configTIMER_POOL_SIZE > 0 )
+    {
+        if( listLIST_IS_EMPTY( &xFreeTimerList ) == pdFALSE ) {
+            pxNewTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xFreeTimerList );
+            ( void ) uxListRemove( &( pxNewTimer->xTimerListItem ) );
+        }
+        else {
+            /* The pool is exhausted. */
+            pxNewTimer = NULL;
+        }
+    }
+    #else
+    {
+        pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
+    }
+    #endif /* configTIMER_POOL_SIZE */
+
+    if( pxNewTimer != NULL ) {
+        /* Status is thus far zero as the timer is not created statically
+         * and has not been started.  The auto-reload bit may get set in
+         * prvInitialiseNewTimer. */
+        pxNewTimer->ucStatus = 0x00;
+        prvInitialiseNewTimer( pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction, pxNewTimer );
+        tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_CREATE, pxNewTimer, xTimerPeriodInTicks, ( uxAutoReload != pdFALSE ) ? tmrWORKLOAD_FLAG_AUTORELOAD : 0U );
+    }
+
+    return pxNewTimer;
+}
+
+/*-----------------------------------------------------------*/
+
+TimerHandle_t xTimerCreateStatic( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                  const TickType_t xTimerPeriodInTicks,
+                                  const UBaseType_t uxAutoReload,
+                                  void * const pvTimerID,
+                                  TimerCallbackFunction_t pxCallbackFunction,
+                                  StaticTimer_t * pxTimerBuffer )
+{
+    Timer_t * pxNewTimer;
+
+    /* A pointer to a StaticTimer_t structure MUST be provided, use it. */
+    configASSERT( pxTimerBuffer );
+    pxNewTimer = ( Timer_t * ) pxTimerBuffer; /*lint !e740 !e9087 StaticTimer_t is a pointer to a Timer_t, so guaranteed to be aligned and sized correctly (checked above). */
+
+    if( pxNewTimer != NULL ) {
+        /* Timers can be created statically or dynamically so note this
+         * timer was created statically in case it is later deleted.  The
+         * auto-reload bit may get set in prvInitialiseNewTimer(). */
+        pxNewTimer->ucStatus = ( uint8_t ) tmrSTATUS_IS_STATICALLY_ALLOCATED;
+        prvInitialiseNewTimer( pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction, pxNewTimer );
+        tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_CREATE, pxNewTimer, xTimerPeriodInTicks, ( uxAutoReload != pdFALSE ) ? tmrWORKLOAD_FLAG_AUTORELOAD : 0U );
+    }
+
+    return pxNewTimer;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIMER_RESCHEDULE == 1 )
+
+TimerHandle_t xTimerCreateRescheduling( const char * const pcTimerName,
+                                        const TickType_t xFirstDelayInTicks,
+                                        void * const pvTimerID,
+                                        TimerRescheduleFunction_t pxRescheduleFunction ) {
+    Timer_t * pxNewTimer;
+
+    configASSERT( pxRescheduleFunction );
+
+    /* Stored as an ordinary callback, the status bit says how to call it. */
+    pxNewTimer = xTimerCreate( pcTimerName, xFirstDelayInTicks, pdFALSE, pvTimerID, ( TimerCallbackFunction_t ) ( void ( * )( void ) ) pxRescheduleFunction );
+
+    if( pxNewTimer != NULL ) {
+        pxNewTimer->ucStatus |= tmrSTATUS_IS_RESCHEDULING;
+    }
+
+    return pxNewTimer;
+}
+/*-----------------------------------------------------------*/
+
+TimerHandle_t xTimerCreateReschedulingStatic( const char * const pcTimerName,
+                                              const TickType_t xFirstDelayInTicks,
+                                              void * const pvTimerID,
+                                              TimerRescheduleFunction_t pxRescheduleFunction,
+                                              StaticTimer_t * pxTimerBuffer ) {
+    Timer_t * pxNewTimer;
+
+    configASSERT( pxRescheduleFunction );
+
+    pxNewTimer = xTimerCreateStatic( pcTimerName, xFirstDelayInTicks, pdFALSE, pvTimerID, ( TimerCallbackFunction_t ) ( void ( * )( void ) ) pxRescheduleFunction, pxTimerBuffer );
+
+    if( pxNewTimer != NULL ) {
+        pxNewTimer->ucStatus |= tmrSTATUS_IS_RESCHEDULING;
+    }
+
+    return pxNewTimer;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_RESCHEDULE */
+
+BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer ) {
+    BaseType_t xReturn;
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    /* Is the timer in the list of active timers? */
+    if( ( tmrLOAD_STATUS( pxTimer ) & tmrSTATUS_IS_ACTIVE ) == 0 ) {
+        xReturn = pdFALSE;
+    }
+    else {
+        xReturn = pdTRUE;
+    }
+
+    return xReturn;
+} /*lint !e818 Can't be pointer to const due to the typedef. */
+/*-----------------------------------------------------------*/
+
+void * pvTimerGetTimerID( const TimerHandle_t xTimer ) {
+    Timer_t * const pxTimer = xTimer;
+    void * pvReturn;
+
+    configASSERT( xTimer );
+
+    pvReturn = pxTimer->pvTimerID;
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerSetTimerID( TimerHandle_t xTimer, void * pvNewID ) {
+    Timer_t * const pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    pxTimer->pvTimerID = pvNewID;
+}
+
+static void prvStartTimer( Timer_t * const pxTimer,
+                           const TickType_t xCommandTime,
+                           const TickType_t xTimeNow ) {
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_START, pxTimer, xCommandTime, 0U );
+
+    #if ( configUSE_TIMER_LAZY_RESET == 1 )
+    {
+        /* A running timer is only ever pushed back by a restart, unless the
+         * command is older than the current expiry.  Record the deadline and
+         * leave the timer where it is.  A timer already queued for its
+         * callback is past that point and is moved at once. */
+        if( ( ( pxTimer->ucStatus & tmrSTATUS_IS_LAZY_RESET ) != 0 ) &&
+            tmrIS_IN_ACTIVE_LIST( pxTimer ) &&
+            ( ( TickType_t ) ( listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) - xCommandTime ) <= pxTimer->xTimerPeriodInTicks ) ) {
+            tmrBEGIN_STATE_WRITE( pxTimer );
+            pxTimer->xLazyExpiryTime = xCommandTime + pxTimer->xTimerPeriodInTicks;
+            tmrSET_STATUS( pxTimer, tmrSTATUS_RESET_PENDING );
+            tmrEND_STATE_WRITE( pxTimer );
+            traceTIMER_START( pxTimer, pxTimer->xLazyExpiryTime );
+            return;
+        }
+    }
+    #endif /* configUSE_TIMER_LAZY_RESET */
+
+    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
+        /* The timer is in a list, remove it. */
+        prvActiveListRemove( pxTimer );
+    }
+
+    tmrLEAVE_PERIOD_GROUP( pxTimer );
+
+    traceTIMER_START( pxTimer, xCommandTime + pxTimer->xTimerPeriodInTicks );
+
+    if( prvInsertTimerInActiveList( pxTimer, xCommandTime + pxTimer->xTimerPeriodInTicks, xTimeNow, xCommandTime ) != pdFALSE ) {
+        /* The timer expired before it was added to the active
+         * timer list.  Process it now, as if it had come off the list, so
+         * it is rearmed the same way. */
+        prvExpireTimer( pxTimer, xCommandTime + pxTimer->xTimerPeriodInTicks, xTimeNow );
+    }
+}
+
+BaseType_t xTimerStart( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
+    BaseType_t xTimerListsWereSwitched;
+    uint32_t xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+    configASSERT( xTimer );
+    tmrPROBE2( start, xTimer, xTimeNow + xTimerGetPeriod( xTimer ) );
+    prvStartTimer( xTimer, xTimeNow, xTimeNow );
+
+    return pdTRUE;
+}
+
+BaseType_t xTimerStop( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_STOP, pxTimer, 0U, 0U );
+    tmrPROBE1( stop, pxTimer );
+
+    /* The timer is in a list until it either expires or is stopped.  Unlinking
+     * it is O(1) as the list item knows which list it is in. */
+    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
+        prvActiveListRemove( pxTimer );
+    }
+
+    tmrLEAVE_PERIOD_GROUP( pxTimer );
+
+    tmrBEGIN_STATE_WRITE( pxTimer );
+    tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE | tmrSTATUS_RESET_PENDING );
+    tmrEND_STATE_WRITE( pxTimer );
+
+    #if ( configUSE_TIMER_BACKOFF == 1 )
+        if( pxTimer->pxBackoffPolicy != NULL ) {
+            /* Stopped once the retry succeeded, the next start begins a new
+             * series. */
+            prvBackoffRestart( pxTimer );
+        }
+    #endif
+
+    traceTIMER_STOP( pxTimer );
+    return pdTRUE;
+}
+
+BaseType_t xTimerChangePeriod( TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait ) {
+    Timer_t * pxTimer = xTimer;
+    BaseType_t xTimerListsWereSwitched;
+    uint32_t xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_CHANGE_PERIOD, pxTimer, xNewPeriod, 0U );
+
+    /* A timer with its own period no longer follows its group.  A running
+     * timer is unlinked before it is inserted again for the new period. */
+    tmrLEAVE_PERIOD_GROUP( pxTimer );
+
+    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
+        prvActiveListRemove( pxTimer );
+    }
+
+    tmrSTORE_PERIOD( pxTimer, xNewPeriod );
+    configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+    traceTIMER_CHANGE_PERIOD( pxTimer, xNewPeriod );
+    tmrRECORD_PERIOD( xNewPeriod );
+
+    /* The new period does not really have a reference, and can
+     * be longer or shorter than the old one.  The command time is
+     * therefore set to the current time, and as the period cannot
+     * be zero the next expiry time can only be in the future,
+     * meaning (unlike for the xTimerStart() case above) there is
+     * no fail case that needs to be handled here. */
+    ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+
+    return pdTRUE;
+}
+
+BaseType_t xTimerDelete( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
+    Timer_t * pxTimer = xTimer;
+
+    #if ( configTIMER_POOL_SIZE > 0 )
+    {
+        /* Deleting a pooled timer twice would link it into the free list
+         * twice. */
+        if( listIS_CONTAINED_WITHIN( &xFreeTimerList, &( pxTimer->xTimerListItem ) ) != pdFALSE ) {
+            return pdFALSE;
+        }
+    }
+    #endif /* configTIMER_POOL_SIZE */
+
+    /* A deleted timer must not be left referenced from an active list, nor
+     * from the member list of a group. */
+    ( void ) xTimerStop( xTimer, xTicksToWait );
+    tmrLEAVE_TIMER_GROUP( pxTimer );
+    tmrRECORD_WORKLOAD( tmrWORKLOAD_OP_DELETE, pxTimer, 0U, 0U );
+
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+    {
+        CallbackFrame_t * pxFrame;
+
+        for( pxFrame = pxCallbackFrames; pxFrame != NULL; pxFrame = pxFrame->pxOuter ) {
+            if( pxFrame->pxTimer == pxTimer ) {
+                pxFrame->pxTimer = NULL;
+            }
+        }
+    }
+    #endif
+
+    if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 ) {
+        #if ( configTIMER_POOL_SIZE > 0 )
+        {
+            UBaseType_t uxIndex = ( UBaseType_t ) ( pxTimer - xTimerPool );
+
+            configASSERT( uxIndex < ( UBaseType_t ) configTIMER_POOL_SIZE );
+
+            /* Invalidate every outstanding reference to this slot, skipping
+             * generation 0, then give the slot back to the pool. */
+            xTimerPoolGeneration[ uxIndex ] = ( xTimerPoolGeneration[ uxIndex ] + 1U ) & tmrREF_GENERATION_MASK;
+
+            if( xTimerPoolGeneration[ uxIndex ] == 0U ) {
+                xTimerPoolGeneration[ uxIndex ] = 1U;
+            }
+
+            vListInsertEnd( &xFreeTimerList, &( pxTimer->xTimerListItem ) );
+        }
+        #else
+        {
+            vPortFree( pxTimer );
+        }
+        #endif /* configTIMER_POOL_SIZE */
+    }
+    else {
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+    }
+
+    return pdTRUE;
+}
+
+#if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+
+#define tmrCOMPACT_KEY( ulIndex )    ( ( TickType_t ) ( xCompactTimers[ ulIndex ].xExpiryTime - xCompactBase ) )
+
+static CompactTimer_t * prvCompactFromRef( TimerRef_t xRef ) {
+    TimerRef_t xIndex = xRef & tmrCOMPACT_INDEX_MASK;
+    CompactTimer_t * pxReturn = NULL;
+
+    if( ( xIndex < ( TimerRef_t ) configTIMER_COMPACT_POOL_SIZE ) &&
+        ( xCompactTimers[ xIndex ].usGeneration != 0U ) &&
+        ( ( TimerRef_t ) xCompactTimers[ xIndex ].usGeneration == ( xRef >> configTIMER_REF_INDEX_BITS ) ) ) {
+        pxReturn = &( xCompactTimers[ xIndex ] );
+    }
+
+    return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCompactHeapPlace( uint32_t ulPosition,
+                                 uint32_t ulIndex ) {
+    ulCompactHeap[ ulPosition ] = ulIndex;
+    xCompactTimers[ ulIndex ].ulLink = ulPosition;
+}
+
+static void prvCompactSiftUp( uint32_t ulPosition ) {
+    const uint32_t ulIndex = ulCompactHeap[ ulPosition ];
+    const TickType_t xKey = tmrCOMPACT_KEY( ulIndex );
+    uint32_t ulParent;
+
+    while( ulPosition > 0U ) {
+        ulParent = ( ulPosition - 1U ) / 2U;
+
+        if( tmrCOMPACT_KEY( ulCompactHeap[ ulParent ] ) <= xKey ) {
+            break;
+        }
+
+        prvCompactHeapPlace( ulPosition, ulCompactHeap[ ulParent ] );
+        ulPosition = ulParent;
+    }
+
+    prvCompactHeapPlace( ulPosition, ulIndex );
+}
+
+static void prvCompactSiftDown( uint32_t ulPosition ) {
+    const uint32_t ulIndex = ulCompactHeap[ ulPosition ];
+    const TickType_t xKey = tmrCOMPACT_KEY( ulIndex );
+    uint32_t ulChild;
+
+    for( ; ; ) {
+        ulChild = ( ulPosition * 2U ) + 1U;
+
+        if( ulChild >= ulCompactHeapCount ) {
+            break;
+        }
+
+        if( ( ( ulChild + 1U ) < ulCompactHeapCount ) &&
+            ( tmrCOMPACT_KEY( ulCompactHeap[ ulChild + 1U ] ) < tmrCOMPACT_KEY( ulCompactHeap[ ulChild ] ) ) ) {
+            ulChild++;
+        }
+
+        if( xKey <= tmrCOMPACT_KEY( ulCompactHeap[ ulChild ] ) ) {
+            break;
+        }
+
+        prvCompactHeapPlace( ulPosition, ulCompactHeap[ ulChild ] );
+        ulPosition = ulChild;
+    }
+
+    prvCompactHeapPlace( ulPosition, ulIndex );
+}
+
+static void prvCompactHeapInsert( uint32_t ulIndex ) {
+    prvCompactHeapPlace( ulCompactHeapCount, ulIndex );
+    ulCompactHeapCount++;
+    prvCompactSiftUp( ulCompactHeapCount - 1U );
+}
+
+static void prvCompactHeapRemove( uint32_t ulIndex ) {
+    const uint32_t ulPosition = xCompactTimers[ ulIndex ].ulLink;
+    uint32_t ulMoved;
+
+    ulCompactHeapCount--;
+
+    if( ulPosition != ulCompactHeapCount ) {
+        /* Fill the hole with the last record, which may need to move either
+         * way. */
+        ulMoved = ulCompactHeap[ ulCompactHeapCount ];
+        prvCompactHeapPlace( ulPosition, ulMoved );
+        prvCompactSiftDown( ulPosition );
+
+        if( xCompactTimers[ ulMoved ].ulLink == ulPosition ) {
+            prvCompactSiftUp( ulPosition );
+        }
+    }
+
+    xCompactTimers[ ulIndex ].ulLink = tmrCOMPACT_NO_INDEX;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessExpiredCompactTimers( const TickType_t xTimeNow ) {
+    CompactTimer_t * pxTimer;
+    uint32_t ulIndex;
+    uint32_t ulExpired;
+    TimerRef_t xRef;
+
+    for( ulExpired = 0U; ulExpired < ( uint32_t ) configTIMER_COMPACT_MAX_EXPIRIES; ulExpired++ ) {
+        if( ( ulCompactHeapCount == 0U ) ||
+            ( tmrCOMPACT_KEY( ulCompactHeap[ 0 ] ) > ( TickType_t ) ( xTimeNow - xCompactBase ) ) ) {
+            /* Nothing is due, every running timer expires after xTimeNow. */
+            xCompactBase = xTimeNow;
+            return;
+        }
+
+        ulIndex = ulCompactHeap[ 0 ];
+        pxTimer = &( xCompactTimers[ ulIndex ] );
+        xRef = ( ( TimerRef_t ) pxTimer->usGeneration << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) ulIndex;
+
+        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 ) {
+            /* Reinsert relative to the missed expiry, should that already be
+             * in the past the timer stays at the head and catches up one
+             * period per expiry. */
+            pxTimer->xExpiryTime += pxTimer->xTimerPeriodInTicks;
+            prvCompactSiftDown( 0U );
+        }
+        else {
+            prvCompactHeapRemove( ulIndex );
+            tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+        }
+
+        /* The callback may delete the timer, do not touch it afterwards. */
+        pxCompactCallbacks[ pxTimer->ucCallbackIndex ]( xRef );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerCompactRegisterCallback( CompactTimerCallbackFunction_t pxCallbackFunction ) {
+    configASSERT( pxCallbackFunction );
+    configASSERT( uxCompactCallbackCount < ( UBaseType_t ) configTIMER_COMPACT_MAX_CALLBACKS );
+
+    pxCompactCallbacks[ uxCompactCallbackCount ] = pxCallbackFunction;
+    uxCompactCallbackCount++;
+
+    return uxCompactCallbackCount - 1U;
+}
+/*-----------------------------------------------------------*/
+
+TimerRef_t xTimerCompactCreate( const TickType_t xTimerPeriodInTicks,
+                                const UBaseType_t uxAutoReload,
+                                const UBaseType_t uxCallbackIndex ) {
+    CompactTimer_t * pxTimer;
+    uint32_t ulIndex = ulCompactFreeHead;
+
+    /* 0 is not a valid value for xTimerPeriodInTicks. */
+    configASSERT( ( xTimerPeriodInTicks > 0 ) );
+    configASSERT( uxCallbackIndex < uxCompactCallbackCount );
+
+    if( ulIndex == tmrCOMPACT_NO_INDEX ) {
+        return tmrINVALID_TIMER_REF;
+    }
+
+    pxTimer = &( xCompactTimers[ ulIndex ] );
+    ulCompactFreeHead = pxTimer->ulLink;
+
+    pxTimer->xTimerPeriodInTicks = xTimerPeriodInTicks;
+    tmrRECORD_PERIOD( xTimerPeriodInTicks );
+    pxTimer->ulLink = tmrCOMPACT_NO_INDEX;
+    pxTimer->usGeneration = ( uint16_t ) pxTimer->xExpiryTime;
+    pxTimer->ucCallbackIndex = ( uint8_t ) uxCallbackIndex;
+    pxTimer->ucStatus = ( uxAutoReload != pdFALSE ) ? tmrSTATUS_IS_AUTORELOAD : ( uint8_t ) 0U;
+
+    #if ( configTIMER_COMPACT_STORE_ID == 1 )
+        pvCompactTimerIDs[ ulIndex ] = NULL;
+    #endif
+
+    return ( ( TimerRef_t ) pxTimer->usGeneration << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) ulIndex;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerCompactStart( TimerRef_t xRef ) {
+    CompactTimer_t * const pxTimer = prvCompactFromRef( xRef );
+    const uint32_t ulIndex = ( uint32_t ) ( xRef & tmrCOMPACT_INDEX_MASK );
+    BaseType_t xTimerListsWereSwitched;
+    TickType_t xTimeNow;
+
+    if( pxTimer == NULL ) {
+        return pdFALSE;
+    }
+
+    xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+    if( ulCompactHeapCount == 0U ) {
+        xCompactBase = xTimeNow;
+    }
+
+    if( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0 ) {
+        prvCompactHeapRemove( ulIndex );
+    }
+
+    pxTimer->xExpiryTime = xTimeNow + pxTimer->xTimerPeriodInTicks;
+    pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+    prvCompactHeapInsert( ulIndex );
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerCompactStop( TimerRef_t xRef ) {
+    CompactTimer_t * const pxTimer = prvCompactFromRef( xRef );
+
+    if( pxTimer == NULL ) {
+        return pdFALSE;
+    }
+
+    if( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0 ) {
+        prvCompactHeapRemove( ( uint32_t ) ( xRef & tmrCOMPACT_INDEX_MASK ) );
+        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerCompactChangePeriod( TimerRef_t xRef,
+                                      TickType_t xNewPeriod ) {
+    CompactTimer_t * const pxTimer = prvCompactFromRef( xRef );
+
+    configASSERT( ( xNewPeriod > 0 ) );
+
+    if( pxTimer == NULL ) {
+        return pdFALSE;
+    }
+
+    /* As xTimerChangePeriod(), this also starts the timer. */
+    pxTimer->xTimerPeriodInTicks = xNewPeriod;
+    tmrRECORD_PERIOD( xNewPeriod );
+
+    return xTimerCompactStart( xRef );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerCompactDelete( TimerRef_t xRef ) {
+    const uint32_t ulIndex = ( uint32_t ) ( xRef & tmrCOMPACT_INDEX_MASK );
+    CompactTimer_t * pxTimer;
+
+    if( xTimerCompactStop( xRef ) == pdFALSE ) {
+        return pdFALSE;
+    }
+
+    pxTimer = &( xCompactTimers[ ulIndex ] );
+
+    /* Invalidate every outstanding reference, skipping generation 0 which
+     * marks a free record. */
+    pxTimer->xExpiryTime = ( TickType_t ) ( ( pxTimer->usGeneration + 1U ) & tmrCOMPACT_GENERATION_MASK );
+
+    if( pxTimer->xExpiryTime == 0U ) {
+        pxTimer->xExpiryTime = 1U;
+    }
+
+    pxTimer->usGeneration = 0U;
+    pxTimer->ulLink = ulCompactFreeHead;
+    ulCompactFreeHead = ulIndex;
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerCompactIsTimerActive( TimerRef_t xRef ) {
+    CompactTimer_t * const pxTimer = prvCompactFromRef( xRef );
+
+    return ( ( pxTimer != NULL ) && ( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0 ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configTIMER_COMPACT_STORE_ID == 1 )
+
+void * pvTimerCompactGetTimerID( TimerRef_t xRef ) {
+    configASSERT( prvCompactFromRef( xRef ) );
+    return pvCompactTimerIDs[ xRef & tmrCOMPACT_INDEX_MASK ];
+}
+/*-----------------------------------------------------------*/
+
+void vTimerCompactSetTimerID( TimerRef_t xRef,
+                              void * pvNewID ) {
+    configASSERT( prvCompactFromRef( xRef ) );
+    pvCompactTimerIDs[ xRef & tmrCOMPACT_INDEX_MASK ] = pvNewID;
+}
+
+#endif /* configTIMER_COMPACT_STORE_ID */
+
+#endif /* configTIMER_COMPACT_POOL_SIZE */
+
+#if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+
+PeriodGroupHandle_t xTimerPeriodGroupCreate( const char * const pcGroupName,
+                                             const TickType_t xPeriodInTicks ) {
+    PeriodGroup_t * pxGroup = NULL;
+
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        if( pxFreePeriodGroups != NULL ) {
+            pxGroup = pxFreePeriodGroups;
+            pxFreePeriodGroups = pxGroup->pxNextFree;
+        }
+    #endif
+
+    if( pxGroup == NULL ) {
+        pxGroup = ( PeriodGroup_t * ) pvPortMalloc( sizeof( PeriodGroup_t ) );
+    }
+
+    if( pxGroup != NULL ) {
+        /* The anchor is embedded in the group, so it is marked as statically
+         * allocated to keep it from being freed on its own. */
+        pxGroup->xAnchor.ucStatus = ( uint8_t ) tmrSTATUS_IS_STATICALLY_ALLOCATED;
+        prvInitialiseNewTimer( pcGroupName, xPeriodInTicks, pdTRUE, pxGroup, prvPeriodGroupCallback, &( pxGroup->xAnchor ) );
+        pxGroup->ppxMembers = NULL;
+        pxGroup->uxCount = 0U;
+        pxGroup->uxCapacity = 0U;
+        pxGroup->uxHoles = 0U;
+        pxGroup->xDispatching = pdFALSE;
+    }
+
+    return pxGroup;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerPeriodGroupAdd( PeriodGroupHandle_t xGroup,
+                                 TimerHandle_t xTimer ) {
+    PeriodGroup_t * const pxGroup = xGroup;
+    Timer_t * const pxTimer = xTimer;
+    Timer_t ** ppxMembers;
+    UBaseType_t uxCapacity;
+    UBaseType_t x;
+    BaseType_t xTimerListsWereSwitched;
+    TickType_t xTimeNow;
+
+    configASSERT( xGroup );
+    configASSERT( xTimer );
+
+    if( pxTimer->pxPeriodGroup == pxGroup ) {
+        return pdTRUE;
+    }
+
+    if( pxGroup->uxCount == pxGroup->uxCapacity ) {
+        uxCapacity = ( pxGroup->uxCapacity == 0U ) ? tmrGROUP_MIN_CAPACITY : ( pxGroup->uxCapacity * 2U );
+        ppxMembers = ( Timer_t ** ) pvPortMalloc( ( size_t ) uxCapacity * sizeof( Timer_t * ) );
+
+        if( ppxMembers == NULL ) {
+            return pdFALSE;
+        }
+
+        for( x = 0; x < pxGroup->uxCount; x++ ) {
+            ppxMembers[ x ] = pxGroup->ppxMembers[ x ];
+        }
+
+        if( pxGroup->ppxMembers != NULL ) {
+            vPortFree( pxGroup->ppxMembers );
+        }
+
+        pxGroup->ppxMembers = ppxMembers;
+        pxGroup->uxCapacity = uxCapacity;
+    }
+
+    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
+        prvActiveListRemove( pxTimer );
+    }
+
+    tmrLEAVE_PERIOD_GROUP( pxTimer );
+
+    tmrBEGIN_STATE_WRITE( pxTimer );
+    tmrSTORE_PERIOD( pxTimer, pxGroup->xAnchor.xTimerPeriodInTicks );
+    tmrSET_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+    pxTimer->pxPeriodGroup = pxGroup;
+    tmrEND_STATE_WRITE( pxTimer );
+    pxTimer->uxGroupIndex = pxGroup->uxCount;
+    pxGroup->ppxMembers[ pxGroup->uxCount ] = pxTimer;
+    pxGroup->uxCount++;
+    uxPeriodGroupMembers++;
+
+    if( ( pxGroup->xAnchor.ucStatus & tmrSTATUS_IS_ACTIVE ) == 0 ) {
+        /* First member, the group takes its phase from now. */
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+        prvStartTimer( &( pxGroup->xAnchor ), xTimeNow, xTimeNow );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerPeriodGroupGetCount( PeriodGroupHandle_t xGroup ) {
+    PeriodGroup_t * const pxGroup = xGroup;
+
+    configASSERT( xGroup );
+    return pxGroup->uxCount - pxGroup->uxHoles;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerPeriodGroupDelete( PeriodGroupHandle_t xGroup ) {
+    PeriodGroup_t * const pxGroup = xGroup;
+    Timer_t * pxTimer;
+    UBaseType_t x;
+
+    configASSERT( xGroup );
+    configASSERT( pxGroup->xDispatching == pdFALSE );
+
+    /* The members stay valid timers, they are just no longer running. */
+    for( x = 0; x < pxGroup->uxCount; x++ ) {
+        pxTimer = pxGroup->ppxMembers[ x ];
+        tmrBEGIN_STATE_WRITE( pxTimer );
+        pxTimer->pxPeriodGroup = NULL;
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+        tmrEND_STATE_WRITE( pxTimer );
+    }
+
+    uxPeriodGroupMembers -= pxGroup->uxCount - pxGroup->uxHoles;
+    ( void ) xTimerStop( &( pxGroup->xAnchor ), 0 );
+
+    if( pxGroup->ppxMembers != NULL ) {
+        vPortFree( pxGroup->ppxMembers );
+    }
+
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        pxGroup->pxNextFree = pxFreePeriodGroups;
+        pxFreePeriodGroups = pxGroup;
+    #else
+        vPortFree( pxGroup );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodGroupRemove( Timer_t * const pxTimer ) {
+    PeriodGroup_t * const pxGroup = pxTimer->pxPeriodGroup;
+    Timer_t * pxLast;
+
+    if( pxGroup->xDispatching != pdFALSE ) {
+        /* Moving the last member into the hole could make the fan-out skip
+         * it or call it twice, so leave a hole that is squeezed out once the
+         * fan-out is done. */
+        pxGroup->ppxMembers[ pxTimer->uxGroupIndex ] = NULL;
+        pxGroup->uxHoles++;
+    }
+    else {
+        pxGroup->uxCount--;
+        pxLast = pxGroup->ppxMembers[ pxGroup->uxCount ];
+        pxGroup->ppxMembers[ pxTimer->uxGroupIndex ] = pxLast;
+        pxLast->uxGroupIndex = pxTimer->uxGroupIndex;
+
+        if( pxGroup->uxCount == 0U ) {
+            ( void ) xTimerStop( &( pxGroup->xAnchor ), 0 );
+        }
+    }
+
+    uxPeriodGroupMembers--;
+
+    tmrBEGIN_STATE_WRITE( pxTimer );
+    pxTimer->pxPeriodGroup = NULL;
+    tmrEND_STATE_WRITE( pxTimer );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodGroupCallback( TimerHandle_t xAnchor ) {
+    PeriodGroup_t * const pxGroup = ( PeriodGroup_t * ) pvTimerGetTimerID( xAnchor );
+    const UBaseType_t uxCount = pxGroup->uxCount;
+    Timer_t * pxTimer;
+    UBaseType_t x;
+    UBaseType_t y;
+
+    /* Timers added by a callback are appended past uxCount and first expire
+     * one period from now. */
+    pxGroup->xDispatching = pdTRUE;
+
+    for( x = 0; x < uxCount; x++ ) {
+        pxTimer = pxGroup->ppxMembers[ x ];
+
+        if( pxTimer == NULL ) {
+            continue;
+        }
+
+        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) == 0 ) {
+            prvPeriodGroupRemove( pxTimer );
+            tmrCLEAR_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+        }
+
+        /* The callback may stop, restart or delete any member, including
+         * this one, which leaves a hole instead of moving other members. */
+        ( void ) prvCallTimerCallback( pxTimer );
+    }
+
+    pxGroup->xDispatching = pdFALSE;
+
+    if( pxGroup->uxHoles != 0U ) {
+        for( x = 0, y = 0; x < pxGroup->uxCount; x++ ) {
+            if( pxGroup->ppxMembers[ x ] != NULL ) {
+                pxGroup->ppxMembers[ y ] = pxGroup->ppxMembers[ x ];
+                pxGroup->ppxMembers[ y ]->uxGroupIndex = y;
+                y++;
+            }
+        }
+
+        pxGroup->uxCount = y;
+        pxGroup->uxHoles = 0U;
+    }
+
+    if( pxGroup->uxCount == 0U ) {
+        ( void ) xTimerStop( xAnchor, 0 );
+    }
+}
+
+#endif /* configUSE_TIMER_PERIOD_GROUPS */
+
+#if ( configTIMER_QUEUE_LENGTH > 0 )
+
+static BaseType_t prvSendMessage( const DaemonTaskMessage_t * const pxMessage ) {
+    TimerQueueSlot_t * pxSlot;
+    uint32_t ulPosition;
+    uint32_t ulSequence;
+
+    ulPosition = portATOMIC_LOAD_ACQUIRE_U32( &ulQueueTail );
+
+    for( ; ; ) {
+        pxSlot = &( xTimerQueue[ ulPosition & tmrQUEUE_INDEX_MASK ] );
+        ulSequence = portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulSequence ) );
+
+        if( ulSequence == ulPosition ) {
+            /* The slot is free, try to claim it.  On failure ulPosition is
+             * refreshed with the tail another producer moved on to. */
+            if( portATOMIC_COMPARE_EXCHANGE_U32( &ulQueueTail, &ulPosition, ulPosition + 1U ) ) {
+                break;
+            }
+        }
+        else if( ( int32_t ) ( ulSequence - ulPosition ) < 0 ) {
+            /* The consumer has not freed this slot yet, the queue is full. */
+            return pdFALSE;
+        }
+        else {
+            /* Another producer claimed the slot first. */
+            ulPosition = portATOMIC_LOAD_ACQUIRE_U32( &ulQueueTail );
+        }
+    }
+
+    pxSlot->xMessage = *pxMessage;
+    portATOMIC_STORE_RELEASE_U32( &( pxSlot->ulSequence ), ulPosition + 1U );
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerGenericCommandFromISR( TimerHandle_t xTimer,
+                                        const BaseType_t xCommandID,
+                                        const TickType_t xOptionalValue,
+                                        BaseType_t * const pxHigherPriorityTaskWoken ) {
+    DaemonTaskMessage_t xMessage;
+
+    configASSERT( xTimer );
+
+    /* Nothing is woken, the command waits for the next dk_timer_task(). */
+    if( pxHigherPriorityTaskWoken != NULL ) {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+
+    xMessage.xMessageID = xCommandID;
+    xMessage.u.xTimerParameters.pxTimer = xTimer;
+
+    #if ( configTIMER_POOL_SIZE > 0 )
+        xMessage.u.xTimerParameters.xTimerRef = xTimerGetRef( xTimer );
+    #endif
+
+    if( xCommandID == tmrCOMMAND_CHANGE_PERIOD_FROM_ISR ) {
+        xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
+    }
+    else {
+        /* The command time, so a start is not delayed by the queue. */
+        xMessage.u.xTimerParameters.xMessageValue = sys_get_TickCount();
+    }
+
+    if( prvSendMessage( &xMessage ) == pdFALSE ) {
+        return pdFALSE;
+    }
+
+    if( xCommandID == tmrCOMMAND_CHANGE_PERIOD_FROM_ISR ) {
+        portTIMER_SERVICE_NOTIFY( sys_get_TickCount() + xOptionalValue );
+    }
+    else if( xCommandID != tmrCOMMAND_STOP_FROM_ISR ) {
+        portTIMER_SERVICE_NOTIFY( xMessage.u.xTimerParameters.xMessageValue + xTimerGetPeriod( xTimer ) );
+    }
+    else {
+        /* A stop never brings the next expiry forward. */
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend,
+                                          void * pvParameter1,
+                                          uint32_t ulParameter2,
+                                          BaseType_t * pxHigherPriorityTaskWoken ) {
+    DaemonTaskMessage_t xMessage;
+
+    configASSERT( xFunctionToPend );
+
+    if( pxHigherPriorityTaskWoken != NULL ) {
+        *pxHigherPriorityTaskWoken = pdFALSE;
+    }
+
+    /* Complete the message with the function parameters and post it to the
+     * daemon task. */
+    xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR;
+    xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
+    xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
+    xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+
+    if( prvSendMessage( &xMessage ) == pdFALSE ) {
+        return pdFALSE;
+    }
+
+    portTIMER_SERVICE_NOTIFY( sys_get_TickCount() );
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend,
+                                   void * pvParameter1,
+                                   uint32_t ulParameter2,
+                                   TickType_t xTicksToWait ) {
+    DaemonTaskMessage_t xMessage;
+
+    configASSERT( xFunctionToPend );
+
+    xMessage.xMessageID = tmrCOMMAND_EXECUTE_CALLBACK;
+    xMessage.u.xCallbackParameters.pxCallbackFunction = xFunctionToPend;
+    xMessage.u.xCallbackParameters.pvParameter1 = pvParameter1;
+    xMessage.u.xCallbackParameters.ulParameter2 = ulParameter2;
+
+    if( prvSendMessage( &xMessage ) == pdFALSE ) {
+        return pdFALSE;
+    }
+
+    portTIMER_SERVICE_NOTIFY( sys_get_TickCount() );
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessReceivedCommands( void ) {
+    DaemonTaskMessage_t xMessage;
+    TimerQueueSlot_t * pxSlot;
+    Timer_t * pxTimer;
+    BaseType_t xTimerListsWereSwitched;
+    TickType_t xTimeNow;
+    uint32_t ulCount;
+
+    /* Bounded, so commands posted while this runs cannot keep dk_timer_task()
+     * from processing expired timers. */
+    for( ulCount = 0U; ulCount < ( uint32_t ) configTIMER_QUEUE_LENGTH; ulCount++ ) {
+        pxSlot = &( xTimerQueue[ ulQueueHead & tmrQUEUE_INDEX_MASK ] );
+
+        if( portATOMIC_LOAD_ACQUIRE_U32( &( pxSlot->ulSequence ) ) != ( ulQueueHead + 1U ) ) {
+            /* Empty, or the next message is still being written. */
+            break;
+        }
+
+        xMessage = pxSlot->xMessage;
+        portATOMIC_STORE_RELEASE_U32( &( pxSlot->ulSequence ), ulQueueHead + ( uint32_t ) configTIMER_QUEUE_LENGTH );
+        ulQueueHead++;
+
+        /* Negative commands are pended function calls, not timer commands. */
+        if( xMessage.xMessageID < ( BaseType_t ) 0 ) {
+            const CallbackParameters_t * const pxCallback = &( xMessage.u.xCallbackParameters );
+
+            /* The timer uses the xCallbackParameters member to request a
+             * callback be executed.  Check the callback is not NULL. */
+            configASSERT( pxCallback->pxCallbackFunction );
+
+            /* Call the function. */
+            pxCallback->pxCallbackFunction( pxCallback->pvParameter1, pxCallback->ulParameter2 );
+            continue;
+        }
+
+        pxTimer = xMessage.u.xTimerParameters.pxTimer;
+
+        #if ( configTIMER_POOL_SIZE > 0 )
+        {
+            /* Drop commands for pooled timers deleted since they were sent. */
+            if( ( xMessage.u.xTimerParameters.xTimerRef != tmrINVALID_TIMER_REF ) &&
+                ( xTimerFromRef( xMessage.u.xTimerParameters.xTimerRef ) == NULL ) ) {
+                continue;
+            }
+        }
+        #endif /* configTIMER_POOL_SIZE */
+
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+        switch( xMessage.xMessageID ) {
+            case tmrCOMMAND_START_FROM_ISR:
+            case tmrCOMMAND_RESET_FROM_ISR:
+                prvStartTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue, xTimeNow );
+                break;
+
+            case tmrCOMMAND_STOP_FROM_ISR:
+                ( void ) xTimerStop( pxTimer, 0 );
+                break;
+
+            case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                ( void ) xTimerChangePeriod( pxTimer, xMessage.u.xTimerParameters.xMessageValue, 0 );
+                break;
+
+            default:
+                /* Don't expect to get here. */
+                break;
+        }
+    }
+}
+
+#endif /* configTIMER_QUEUE_LENGTH */
+
+#if ( configTIMER_POOL_SIZE > 0 )
+
+TimerRef_t xTimerGetRef( TimerHandle_t xTimer ) {
+    Timer_t * pxTimer = xTimer;
+    TimerRef_t xReturn = tmrINVALID_TIMER_REF;
+
+    configASSERT( xTimer );
+
+    /* Statically created timers are not part of the pool and have no
+     * reference. */
+    if( ( pxTimer >= &( xTimerPool[ 0 ] ) ) && ( pxTimer < &( xTimerPool[ configTIMER_POOL_SIZE ] ) ) ) {
+        UBaseType_t uxIndex = ( UBaseType_t ) ( pxTimer - xTimerPool );
+
+        xReturn = ( xTimerPoolGeneration[ uxIndex ] << configTIMER_REF_INDEX_BITS ) | ( TimerRef_t ) uxIndex;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+TimerHandle_t xTimerFromRef( TimerRef_t xRef ) {
+    TimerRef_t xIndex = xRef & tmrREF_INDEX_MASK;
+    TimerHandle_t xReturn = NULL;
+
+    /* The generation of a slot changes when its timer is deleted, so a
+     * reference to a deleted (and possibly reused) timer no longer matches. */
+    if( ( xIndex < ( TimerRef_t ) configTIMER_POOL_SIZE ) &&
+        ( xTimerPoolGeneration[ xIndex ] == ( xRef >> configTIMER_REF_INDEX_BITS ) ) ) {
+        xReturn = &( xTimerPool[ xIndex ] );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerStartByRef( TimerRef_t xRef, const TickType_t xTicksToWait ) {
+    TimerHandle_t xTimer = xTimerFromRef( xRef );
+
+    return ( xTimer != NULL ) ? xTimerStart( xTimer, xTicksToWait ) : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerStopByRef( TimerRef_t xRef, const TickType_t xTicksToWait ) {
+    TimerHandle_t xTimer = xTimerFromRef( xRef );
+
+    return ( xTimer != NULL ) ? xTimerStop( xTimer, xTicksToWait ) : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerDeleteByRef( TimerRef_t xRef, const TickType_t xTicksToWait ) {
+    TimerHandle_t xTimer = xTimerFromRef( xRef );
+
+    return ( xTimer != NULL ) ? xTimerDelete( xTimer, xTicksToWait ) : pdFALSE;
+}
+
+#endif /* configTIMER_POOL_SIZE */
+
+#if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+
+BaseType_t xTimerSetBackend( UBaseType_t uxNewBackend ) {
+    BaseType_t xReturn = pdTRUE;
+
+    configASSERT( uxNewBackend <= tmrBACKEND_HEAP );
+
+    if( ( uxNewBackend == tmrBACKEND_HEAP ) && ( xHeapsInUse == pdFALSE ) ) {
+        xReturn = prvMoveListsToHeaps();
+    }
+    else if( ( uxNewBackend == tmrBACKEND_LIST ) && ( xHeapsInUse != pdFALSE ) ) {
+        prvMoveHeapsToLists();
+    }
+
+    if( xReturn != pdFALSE ) {
+        uxBackend = uxNewBackend;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerGetActiveBackend( void ) {
+    return ( xHeapsInUse != pdFALSE ) ? tmrBACKEND_HEAP : tmrBACKEND_LIST;
+}
+
+#endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+#if ( configUSE_TIMER_TRACE == 1 )
+
+size_t uxTimerTraceDump( void * pvBuffer, size_t xBufferSize ) {
+    TimerTraceHeader_t * const pxHeader = ( TimerTraceHeader_t * ) pvBuffer;
+    TimerTraceRecord_t * const pxRecords = ( TimerTraceRecord_t * ) ( pxHeader + 1 );
+    const uint32_t ulEnd = ulTraceWriteIndex;
+    uint32_t ulCount;
+    uint32_t ul;
+
+    configASSERT( pvBuffer );
+
+    if( xBufferSize < sizeof( TimerTraceHeader_t ) ) {
+        return 0;
+    }
+
+    /* Copy the newest records that fit, oldest first.  Records written while
+     * the copy is in progress may overwrite ones being copied, which shows
+     * up as a jump in usSequence. */
+    ulCount = ( ulEnd < ( uint32_t ) configTIMER_TRACE_BUFFER_LENGTH ) ? ulEnd : ( uint32_t ) configTIMER_TRACE_BUFFER_LENGTH;
+
+    if( ( ( xBufferSize - sizeof( TimerTraceHeader_t ) ) / sizeof( TimerTraceRecord_t ) ) < ulCount ) {
+        ulCount = ( uint32_t ) ( ( xBufferSize - sizeof( TimerTraceHeader_t ) ) / sizeof( TimerTraceRecord_t ) );
+    }
+
+    for( ul = 0; ul < ulCount; ul++ ) {
+        pxRecords[ ul ] = xTraceBuffer[ ( ulEnd - ulCount + ul ) & ( configTIMER_TRACE_BUFFER_LENGTH - 1U ) ];
+    }
+
+    pxHeader->ulMagic = tmrTRACE_MAGIC;
+    pxHeader->usVersion = tmrTRACE_VERSION;
+    pxHeader->usRecordSize = ( uint16_t ) sizeof( TimerTraceRecord_t );
+    pxHeader->ulCount = ulCount;
+    pxHeader->ulOverwritten = ulEnd - ulCount;
+
+    return sizeof( TimerTraceHeader_t ) + ( ( size_t ) ulCount * sizeof( TimerTraceRecord_t ) );
+}
+/*-----------------------------------------------------------*/
+
+void vTimerTraceClear( void ) {
+    ulTraceWriteIndex = 0U;
+}
+
+#endif /* configUSE_TIMER_TRACE */
+
+#if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+
+void vTimerGetCallbackStats( TimerHandle_t xTimer,
+                             uint32_t * pulMaxTime,
+                             uint64_t * pullTotalTime )
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    if( pulMaxTime != NULL ) {
+        *pulMaxTime = pxTimer->ulCallbackMaxTime;
+    }
+
+    if( pullTotalTime != NULL ) {
+        *pullTotalTime = pxTimer->ullCallbackTotalTime;
+    }
+}
+
+void vTimerResetCallbackStats( TimerHandle_t xTimer )
+{
+    Timer_t * pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    pxTimer->ulCallbackMaxTime = 0U;
+    pxTimer->ullCallbackTotalTime = 0U;
+}
+
+#endif /* configUSE_TIMER_CALLBACK_BUDGET */
+
+#if ( configUSE_TIMER_GROUPS == 1 )
+
+TimerGroupHandle_t xTimerGroupCreate( void ) {
+    TimerGroup_t * pxGroup;
+
+    pxGroup = ( TimerGroup_t * ) pvPortMalloc( sizeof( TimerGroup_t ) );
+
+    if( pxGroup != NULL ) {
+        vListInitialise( &( pxGroup->xMembers ) );
+        pxGroup->ucStatus = 0U;
+    }
+
+    return pxGroup;
+}
+/*-----------------------------------------------------------*/
+
+TimerGroupHandle_t xTimerGroupCreateStatic( StaticTimerGroup_t * pxGroupBuffer ) {
+    TimerGroup_t * const pxGroup = ( TimerGroup_t * ) pxGroupBuffer;
+
+    configASSERT( pxGroupBuffer );
+    vListInitialise( &( pxGroup->xMembers ) );
+    pxGroup->ucStatus = ( uint8_t ) tmrSTATUS_IS_STATICALLY_ALLOCATED;
+
+    return pxGroup;
+}
+/*-----------------------------------------------------------*/
+
+void vTimerGroupAdd( TimerGroupHandle_t xGroup,
+                     TimerHandle_t xTimer ) {
+    TimerGroup_t * const pxGroup = xGroup;
+    Timer_t * const pxTimer = xTimer;
+
+    configASSERT( xTimer );
+
+    tmrLEAVE_TIMER_GROUP( pxTimer );
+
+    if( pxGroup != NULL ) {
+        vListInsertEnd( &( pxGroup->xMembers ), &( pxTimer->xGroupListItem ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTimerGroupGetCount( TimerGroupHandle_t xGroup ) {
+    TimerGroup_t * const pxGroup = xGroup;
+
+    configASSERT( xGroup );
+    return listCURRENT_LIST_LENGTH( &( pxGroup->xMembers ) );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerGroupStop( TimerGroupHandle_t xGroup ) {
+    TimerGroup_t * const pxGroup = xGroup;
+    const ListItem_t * const pxEnd = listGET_END_MARKER( &( pxGroup->xMembers ) );
+    const ListItem_t * pxItem;
+    Timer_t * pxTimer;
+
+    configASSERT( xGroup );
+
+    /* Stopping does not change the membership, so the list can be walked
+     * directly.  Members that are not running are skipped without touching
+     * the active lists. */
+    for( pxItem = listGET_HEAD_ENTRY( &( pxGroup->xMembers ) ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) ) {
+        pxTimer = ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem );
+
+        if( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0U ) {
+            ( void ) xTimerStop( pxTimer, 0 );
+        }
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTimerGroupDelete( TimerGroupHandle_t xGroup ) {
+    TimerGroup_t * const pxGroup = xGroup;
+
+    configASSERT( xGroup );
+
+    /* xTimerDelete() takes each member out of the list. */
+    while( listLIST_IS_EMPTY( &( pxGroup->xMembers ) ) == pdFALSE ) {
+        ( void ) xTimerDelete( ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxGroup->xMembers ) ), 0 );
+    }
+
+    if( ( pxGroup->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 ) {
+        vPortFree( pxGroup );
+    }
+
+    return pdTRUE;
+}
+
+#endif /* configUSE_TIMER_GROUPS */
+
+#if ( configUSE_TIMER_ITERATOR == 1 )
+
+#define tmrITERATOR_NONE    ( ( UBaseType_t ) -1 )
+
+static TickType_t prvIteratorRemaining( const TimerIterator_t * const pxIterator,
+                                        const TickType_t xKey )
+{
+    if( pxIterator->uxPass == 0U ) {
+        /* After an unprocessed wraparound everything in the current list is
+         * due. */
+        if( ( pxIterator->xWrapped != pdFALSE ) || ( xKey <= pxIterator->xTimeNow ) ) {
+            return 0U;
+        }
+    }
+    else if( pxIterator->xWrapped != pdFALSE ) {
+        /* The overflow list already holds keys of the current tick period. */
+        if( xKey <= pxIterator->xTimeNow ) {
+            return 0U;
+        }
+    }
+    else {
+        /* The key is in the next tick period, the subtraction wraps. */
+    }
+
+    return xKey - pxIterator->xTimeNow;
+}
+
+static void prvIteratorEnterPass( TimerIterator_t * const pxIterator,
+                                  const UBaseType_t uxPass )
+{
+    pxIterator->uxPass = uxPass;
+    pxIterator->uxHeapIndex = tmrITERATOR_NONE;
+
+    #if ( configTIMER_ITERATOR_FRONTIER > 0 )
+        pxIterator->xFrontierFull = pdFALSE;
+        pxIterator->uxFrontierCount = 0U;
+    #endif
+
+    if( uxPass < 2U ) {
+        pxIterator->pxNextItem = listGET_HEAD_ENTRY( ( uxPass == 0U ) ? pxCurrentTimerList : pxOverflowTimerList );
+    }
+}
+
+#if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+
+#define tmrHEAP_KEY( ppxTimers, uxIndex )                 listGET_LIST_ITEM_VALUE( &( ( ppxTimers )[ uxIndex ]->xTimerListItem ) )
+#define tmrIN_WINDOW( pxIterator, ppxTimers, uxIndex )    ( prvIteratorRemaining( ( pxIterator ), tmrHEAP_KEY( ( ppxTimers ), ( uxIndex ) ) ) <= ( pxIterator )->xWithinTicks )
+
+/* Heap positions are returned in (key, position) order, which breaks ties
+ * between equal keys the same way on every step. */
+#define tmrITERATOR_BEFORE( ppxTimers, uxA, uxB )                                          \
+    ( ( tmrHEAP_KEY( ( ppxTimers ), ( uxA ) ) < tmrHEAP_KEY( ( ppxTimers ), ( uxB ) ) ) || \
+      ( ( tmrHEAP_KEY( ( ppxTimers ), ( uxA ) ) == tmrHEAP_KEY( ( ppxTimers ), ( uxB ) ) ) && ( ( uxA ) < ( uxB ) ) ) )
+
+#if ( configTIMER_ITERATOR_FRONTIER > 0 )
+
+static BaseType_t prvIteratorFrontierPush( TimerIterator_t * const pxIterator,
+                                           Timer_t * const * const ppxTimers,
+                                           UBaseType_t uxIndex )
+{
+    UBaseType_t * const puxFrontier = pxIterator->uxFrontier;
+    UBaseType_t x = pxIterator->uxFrontierCount;
+    UBaseType_t uxParent;
+
+    if( x == ( UBaseType_t ) configTIMER_ITERATOR_FRONTIER ) {
+        return pdFALSE;
+    }
+
+    pxIterator->uxFrontierCount++;
+
+    while( x > 0U ) {
+        uxParent = ( x - 1U ) / 2U;
+
+        if( !tmrITERATOR_BEFORE( ppxTimers, uxIndex, puxFrontier[ uxParent ] ) ) {
+            break;
+        }
+
+        puxFrontier[ x ] = puxFrontier[ uxParent ];
+        x = uxParent;
+    }
+
+    puxFrontier[ x ] = uxIndex;
+    return pdTRUE;
+}
+
+#endif /* configTIMER_ITERATOR_FRONTIER */
+
+static UBaseType_t prvIteratorNextInHeap( TimerIterator_t * const pxIterator,
+                                          List_t * const pxList )
+{
+    Timer_t ** const ppxTimers = prvGetHeap( pxList )->ppxTimers;
+    const UBaseType_t uxCount = listCURRENT_LIST_LENGTH( pxList );
+    UBaseType_t uxBest = tmrITERATOR_NONE;
+    TickType_t xBestKey = 0U;
+    TickType_t xKey;
+    UBaseType_t x = 0U;
+    UBaseType_t uxChild;
+
+    if( ( uxCount == 0U ) || !tmrIN_WINDOW( pxIterator, ppxTimers, 0U ) ) {
+        return tmrITERATOR_NONE;
+    }
+
+    #if ( configTIMER_ITERATOR_FRONTIER > 0 )
+        if( pxIterator->xFrontierFull == pdFALSE ) {
+            UBaseType_t * const puxFrontier = pxIterator->uxFrontier;
+            UBaseType_t uxLast;
+
+            /* Every subtree of a heap holds only keys at or after its root,
+             * so a timer can only come next once its parent has been
+             * returned.  Start from the root, then take the smallest of the
+             * frontier and replace it with its children in the window. */
+            if( pxIterator->uxHeapIndex == tmrITERATOR_NONE ) {
+                ( void ) prvIteratorFrontierPush( pxIterator, ppxTimers, 0U );
+            }
+
+            if( pxIterator->uxFrontierCount == 0U ) {
+                return tmrITERATOR_NONE;
+            }
+
+            uxBest = puxFrontier[ 0 ];
+            uxLast = puxFrontier[ --( pxIterator->uxFrontierCount ) ];
+
+            /* Sift the last entry down from the top. */
+            for( ; ; ) {
+                uxChild = ( 2U * x ) + 1U;
+
+                if( uxChild >= pxIterator->uxFrontierCount ) {
+                    break;
+                }
+
+                if( ( ( uxChild + 1U ) < pxIterator->uxFrontierCount ) &&
+                    tmrITERATOR_BEFORE( ppxTimers, puxFrontier[ uxChild + 1U ], puxFrontier[ uxChild ] ) ) {
+                    uxChild++;
+                }
+
+                if( !tmrITERATOR_BEFORE( ppxTimers, puxFrontier[ uxChild ], uxLast ) ) {
+                    break;
+                }
+
+                puxFrontier[ x ] = puxFrontier[ uxChild ];
+                x = uxChild;
+            }
+
+            puxFrontier[ x ] = uxLast;
+
+            for( uxChild = ( 2U * uxBest ) + 1U; ( uxChild <= ( ( 2U * uxBest ) + 2U ) ) && ( uxChild < uxCount ); uxChild++ ) {
+                if( tmrIN_WINDOW( pxIterator, ppxTimers, uxChild ) &&
+                    ( prvIteratorFrontierPush( pxIterator, ppxTimers, uxChild ) == pdFALSE ) ) {
+                    /* uxBest is still the right answer, the scan below
+                     * carries on from it. */
+                    pxIterator->xFrontierFull = pdTRUE;
+                }
+            }
+
+            return uxBest;
+        }
+    #endif /* configTIMER_ITERATOR_FRONTIER */
+
+    /* The timers within the window form a subtree at the top of the heap.
+     * Walk it in pre-order without a stack and pick the smallest (key,
+     * position) after the one returned last. */
+    for( ; ; ) {
+        xKey = tmrHEAP_KEY( ppxTimers, x );
+
+        if( ( pxIterator->uxHeapIndex == tmrITERATOR_NONE ) ||
+            ( xKey > pxIterator->xHeapKey ) ||
+            ( ( xKey == pxIterator->xHeapKey ) && ( x > pxIterator->uxHeapIndex ) ) ) {
+            if( ( uxBest == tmrITERATOR_NONE ) || ( xKey < xBestKey ) || ( ( xKey == xBestKey ) && ( x < uxBest ) ) ) {
+                uxBest = x;
+                xBestKey = xKey;
+            }
+        }
+
+        uxChild = ( 2U * x ) + 1U;
+
+        if( ( uxChild < uxCount ) && tmrIN_WINDOW( pxIterator, ppxTimers, uxChild ) ) {
+            x = uxChild;
+            continue;
+        }
+
+        if( ( ( uxChild + 1U ) < uxCount ) && tmrIN_WINDOW( pxIterator, ppxTimers, uxChild + 1U ) ) {
+            x = uxChild + 1U;
+            continue;
+        }
+
+        /* Climb until a left child with a right sibling in the window. */
+        for( ; ; ) {
+            if( x == 0U ) {
+                return uxBest;
+            }
+
+            if( ( ( x & 1U ) != 0U ) && ( ( x + 1U ) < uxCount ) && tmrIN_WINDOW( pxIterator, ppxTimers, x + 1U ) ) {
+                x++;
+                break;
+            }
+
+            x = ( x - 1U ) / 2U;
+        }
+    }
+}
+
+#undef tmrHEAP_KEY
+#undef tmrIN_WINDOW
+#undef tmrITERATOR_BEFORE
+
+#endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+
+void vTimerIteratorInit( TimerIterator_t * pxIterator,
+                         TickType_t xWithinTicks )
+{
+    configASSERT( pxIterator );
+
+    /* The lists are not switched here, that would process the timers still
+     * in the current list. */
+    pxIterator->xTimeNow = sys_get_TickCount();
+    pxIterator->xWrapped = ( pxIterator->xTimeNow < xLastTime ) ? pdTRUE : pdFALSE;
+    pxIterator->xWithinTicks = xWithinTicks;
+    pxIterator->pvGroup = NULL;
+    pxIterator->uxMember = 0U;
+    pxIterator->xGroupRemaining = 0U;
+    prvIteratorEnterPass( pxIterator, 0U );
+
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        /* The due lists come before the current list. */
+        pxIterator->uxDueClass = ( UBaseType_t ) configTIMER_PRIORITY_CLASSES;
+        pxIterator->pxNextItem = listGET_HEAD_ENTRY( &( xDueTimerLists[ configTIMER_PRIORITY_CLASSES - 1 ] ) );
+    #endif
+}
+
+BaseType_t xTimerIteratorNext( TimerIterator_t * pxIterator,
+                               TimerHandle_t * pxTimer,
+                               TickType_t * pxRemainingTicks )
+{
+    Timer_t * pxNext;
+    List_t * pxList;
+    TickType_t xKey;
+    TickType_t xRemaining;
+
+    configASSERT( pxIterator );
+
+    for( ; ; ) {
+        #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        {
+            PeriodGroup_t * const pxGroup = ( PeriodGroup_t * ) pxIterator->pvGroup;
+
+            if( pxGroup != NULL ) {
+                /* Skip the holes left by members removed in a fan-out. */
+                while( pxIterator->uxMember < pxGroup->uxCount ) {
+                    pxNext = pxGroup->ppxMembers[ pxIterator->uxMember++ ];
+
+                    if( pxNext != NULL ) {
+                        *pxTimer = ( TimerHandle_t ) pxNext;
+                        *pxRemainingTicks = pxIterator->xGroupRemaining;
+                        return pdTRUE;
+                    }
+                }
+
+                pxIterator->pvGroup = NULL;
+            }
+        }
+        #endif /* configUSE_TIMER_PERIOD_GROUPS */
+
+        #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+            if( pxIterator->uxDueClass > 0U ) {
+                pxList = &( xDueTimerLists[ pxIterator->uxDueClass - 1U ] );
+
+                if( pxIterator->pxNextItem == ( ListItem_t * ) listGET_END_MARKER( pxList ) ) {
+                    pxIterator->uxDueClass--;
+
+                    if( pxIterator->uxDueClass > 0U ) {
+                        pxIterator->pxNextItem = listGET_HEAD_ENTRY( &( xDueTimerLists[ pxIterator->uxDueClass - 1U ] ) );
+                    }
+                    else {
+                        prvIteratorEnterPass( pxIterator, 0U );
+                    }
+
+                    continue;
+                }
+
+                /* Queued for the callback, so due, and a lazy reset was
+                 * applied before the timer was queued. */
+                pxNext = ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxIterator->pxNextItem );
+                pxIterator->pxNextItem = listGET_NEXT( pxIterator->pxNextItem );
+
+                #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+                    if( pxNext->pxCallbackFunction == prvPeriodGroupCallback ) {
+                        pxIterator->pvGroup = pvTimerGetTimerID( ( TimerHandle_t ) pxNext );
+                        pxIterator->uxMember = 0U;
+                        pxIterator->xGroupRemaining = 0U;
+                        continue;
+                    }
+                #endif
+
+                *pxTimer = ( TimerHandle_t ) pxNext;
+                *pxRemainingTicks = 0U;
+                return pdTRUE;
+            }
+        #endif /* configUSE_TIMER_PRIORITY_CLASSES */
+
+        if( pxIterator->uxPass >= 2U ) {
+            return pdFALSE;
+        }
+
+        pxList = ( pxIterator->uxPass == 0U ) ? pxCurrentTimerList : pxOverflowTimerList;
+        pxNext = NULL;
+
+        #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+            if( xHeapsInUse != pdFALSE ) {
+                const UBaseType_t uxIndex = prvIteratorNextInHeap( pxIterator, pxList );
+
+                if( uxIndex != tmrITERATOR_NONE ) {
+                    pxNext = prvGetHeap( pxList )->ppxTimers[ uxIndex ];
+                    pxIterator->uxHeapIndex = uxIndex;
+                    pxIterator->xHeapKey = listGET_LIST_ITEM_VALUE( &( pxNext->xTimerListItem ) );
+                }
+            }
+            else
+        #endif /* configUSE_TIMER_ADAPTIVE_BACKEND */
+        {
+            if( pxIterator->pxNextItem != ( ListItem_t * ) listGET_END_MARKER( pxList ) ) {
+                pxNext = ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxIterator->pxNextItem );
+
+                if( prvIteratorRemaining( pxIterator, listGET_LIST_ITEM_VALUE( pxIterator->pxNextItem ) ) > pxIterator->xWithinTicks ) {
+                    pxNext = NULL;
+                }
+                else {
+                    pxIterator->pxNextItem = listGET_NEXT( pxIterator->pxNextItem );
+                }
+            }
+        }
+
+        if( pxNext == NULL ) {
+            /* Nothing more in this list within the window.  The overflow
+             * list only holds later expiries than the current one. */
+            prvIteratorEnterPass( pxIterator, pxIterator->uxPass + 1U );
+            continue;
+        }
+
+        xKey = listGET_LIST_ITEM_VALUE( &( pxNext->xTimerListItem ) );
+        xRemaining = prvIteratorRemaining( pxIterator, xKey );
+
+        #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+            if( pxNext->pxCallbackFunction == prvPeriodGroupCallback ) {
+                pxIterator->pvGroup = pvTimerGetTimerID( ( TimerHandle_t ) pxNext );
+                pxIterator->uxMember = 0U;
+                pxIterator->xGroupRemaining = xRemaining;
+                continue;
+            }
+        #endif
+
+        #if ( configUSE_TIMER_LAZY_RESET == 1 )
+            if( ( pxNext->ucStatus & tmrSTATUS_RESET_PENDING ) != 0 ) {
+                /* A lazy reset only ever moves the deadline back. */
+                const TickType_t xPushedBack = pxNext->xLazyExpiryTime - xKey;
+                const TickType_t xOverdue = pxIterator->xTimeNow - xKey;
+
+                if( xRemaining != 0U ) {
+                    xRemaining += xPushedBack;
+                }
+                else {
+                    xRemaining = ( xPushedBack > xOverdue ) ? ( xPushedBack - xOverdue ) : 0U;
+                }
+            }
+        #endif
+
+        *pxTimer = ( TimerHandle_t ) pxNext;
+        *pxRemainingTicks = xRemaining;
+        return pdTRUE;
+    }
+}
+
+#endif /* configUSE_TIMER_ITERATOR */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+
+static void prvWorkloadRecord( uint8_t ucOp,
+                               TickType_t xTick,
+                               uint32_t ulTimer,
+                               uint32_t ulValue,
+                               uint8_t ucFlags ) {
+    TimerWorkloadRecord_t * const pxRecord = &( xWorkloadBuffer[ uxWorkloadCount ] );
+
+    pxRecord->ulTick = xTick;
+    pxRecord->ulTimer = ulTimer;
+    pxRecord->ulValue = ulValue;
+    pxRecord->ucOp = ucOp;
+    pxRecord->ucFlags = ucFlags;
+    pxRecord->usReserved = 0U;
+
+    if( ++uxWorkloadCount == ( UBaseType_t ) configTIMER_WORKLOAD_BUFFER_LENGTH ) {
+        vTimerWorkloadRecordFlush();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vTimerWorkloadRecordStart( TimerWorkloadWriteFunction_t pxWrite,
+                                void * pvContext ) {
+    TimerWorkloadHeader_t xHeader;
+
+    configASSERT( pxWrite );
+
+    vTimerWorkloadRecordStop();
+
+    xHeader.ulMagic = tmrWORKLOAD_MAGIC;
+    xHeader.usVersion = tmrWORKLOAD_VERSION;
+    xHeader.usRecordSize = ( uint16_t ) sizeof( TimerWorkloadRecord_t );
+    pxWrite( &xHeader, sizeof( xHeader ), pvContext );
+
+    /* Timers that already exist are unknown to the replay, so only the
+     * ones created from now on are replayed. */
+    uxWorkloadCount = 0U;
+    pvWorkloadContext = pvContext;
+    pxWorkloadWrite = pxWrite;
+}
+/*-----------------------------------------------------------*/
 
-        /* Call the timer callback. */
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+void vTimerWorkloadRecordFlush( void ) {
+    const UBaseType_t uxCount = uxWorkloadCount;
+
+    if( ( pxWorkloadWrite != NULL ) && ( uxCount != 0U ) ) {
+        uxWorkloadCount = 0U;
+        pxWorkloadWrite( xWorkloadBuffer, ( size_t ) uxCount * sizeof( TimerWorkloadRecord_t ), pvWorkloadContext );
     }
 }
+/*-----------------------------------------------------------*/
 
-static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) {
-    TickType_t xNextExpireTime;
+void vTimerWorkloadRecordStop( void ) {
+    vTimerWorkloadRecordFlush();
+    pxWorkloadWrite = NULL;
+}
 
-    /* Timers are listed in expiry time order, with the head of the list
-     * referencing the task that will expire first.  Obtain the time at which
-     * the timer with the nearest expiry time will expire.  If there are no
-     * active timers then just set the next expire time to 0.  That will cause
-     * this task to unblock when the tick count overflows, at which point the
-     * timer lists will be switched and the next expiry time can be
-     * re-assessed.  */
-    *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+#endif /* configUSE_TIMER_WORKLOAD_RECORD */
 
-    if( *pxListWasEmpty == pdFALSE ) {
-        xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+#if ( configUSE_TIMER_PERIOD_STATS == 1 )
+
+static void prvRecordPeriod( const TickType_t xPeriod ) {
+    UBaseType_t uxBucket = 0U;
+    UBaseType_t uxMin = 0U;
+    UBaseType_t x;
+
+    if( ( xPeriodStats.ulSamples == 0U ) || ( xPeriod < xPeriodStats.xMinPeriod ) ) {
+        xPeriodStats.xMinPeriod = xPeriod;
     }
-    else {
-        /* Ensure the task unblocks when the tick count rolls over. */
-        xNextExpireTime = ( TickType_t ) 0U;
+
+    if( xPeriod > xPeriodStats.xMaxPeriod ) {
+        xPeriodStats.xMaxPeriod = xPeriod;
     }
 
-    return xNextExpireTime;
-}
+    xPeriodStats.ulSamples++;
 
-static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) {
-    Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+    while( ( xPeriod >> ( uxBucket + 1U ) ) != 0U ) {
+        uxBucket++;
+    }
 
-    /* Remove the timer from the list of active timers.  A check has already
-     * been performed to ensure the list is not empty. */
-    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+    xPeriodStats.ulHistogram[ uxBucket ]++;
 
-    /* If the timer is an auto-reload timer then calculate the next
-     * expiry time and re-insert the timer in the list of active timers. */
-    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 ) {
-        prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+    /* Space-saving count of the most frequent periods: a period that is not
+     * tracked replaces the least frequent one and inherits its count. */
+    for( x = 0; x < ( UBaseType_t ) configTIMER_PERIOD_STATS_TOP; x++ ) {
+        if( ( xPeriodStats.xFrequent[ x ].xPeriod == xPeriod ) || ( xPeriodStats.xFrequent[ x ].ulCount == 0U ) ) {
+            break;
+        }
+
+        if( xPeriodStats.xFrequent[ x ].ulCount < xPeriodStats.xFrequent[ uxMin ].ulCount ) {
+            uxMin = x;
+        }
     }
-    else {
-        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+
+    if( x == ( UBaseType_t ) configTIMER_PERIOD_STATS_TOP ) {
+        x = uxMin;
     }
 
-    /* Call the timer callback. */
-    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+    xPeriodStats.xFrequent[ x ].xPeriod = xPeriod;
+    xPeriodStats.xFrequent[ x ].ulCount++;
+
+    /* Keep the table sorted, most frequent first. */
+    while( ( x > 0U ) && ( xPeriodStats.xFrequent[ x - 1U ].ulCount < xPeriodStats.xFrequent[ x ].ulCount ) ) {
+        const TickType_t xTempPeriod = xPeriodStats.xFrequent[ x - 1U ].xPeriod;
+        const uint32_t ulTempCount = xPeriodStats.xFrequent[ x - 1U ].ulCount;
+
+        xPeriodStats.xFrequent[ x - 1U ].xPeriod = xPeriodStats.xFrequent[ x ].xPeriod;
+        xPeriodStats.xFrequent[ x - 1U ].ulCount = xPeriodStats.xFrequent[ x ].ulCount;
+        xPeriodStats.xFrequent[ x ].xPeriod = xTempPeriod;
+        xPeriodStats.xFrequent[ x ].ulCount = ulTempCount;
+        x--;
+    }
 }
+/*-----------------------------------------------------------*/
 
+void vTimerGetPeriodStats( TimerPeriodStats_t * pxStats ) {
+    configASSERT( pxStats );
+    *pxStats = xPeriodStats;
+}
 /*-----------------------------------------------------------*/
 
-TickType_t xTimerGetPeriod( TimerHandle_t xTimer )
-{
-    Timer_t * pxTimer = xTimer;
+void vTimerResetPeriodStats( void ) {
+    static const TimerPeriodStats_t xEmpty;
 
-    configASSERT( xTimer );
-    return pxTimer->xTimerPeriodInTicks;
+    xPeriodStats = xEmpty;
 }
 /*-----------------------------------------------------------*/
 
-void vTimerSetReloadMode( TimerHandle_t xTimer,
-                          const UBaseType_t uxAutoReload )
-{
-    Timer_t * pxTimer = xTimer;
+void vTimerRecommendTuning( TimerTuning_t * pxTuning ) {
+    const uint32_t ulLowRank = xPeriodStats.ulSamples / 10U;
+    const uint32_t ulHighRank = xPeriodStats.ulSamples - ( xPeriodStats.ulSamples / 100U );
+    uint32_t ulSeen = 0U;
+    UBaseType_t uxLow = 0U;
+    UBaseType_t uxHigh = 0U;
+    UBaseType_t uxBucket;
+    UBaseType_t uxBits;
 
-    configASSERT( xTimer );
-    if( uxAutoReload != pdFALSE )
-    {
-        pxTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
-    }
-    else
-    {
-        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_AUTORELOAD );
+    configASSERT( pxTuning );
+
+    pxTuning->xWheelSlotTicks = 0U;
+    pxTuning->uxWheelLevels = 0U;
+    pxTuning->xGroupPeriod = 0U;
+    pxTuning->ulGroupCount = 0U;
+
+    if( xPeriodStats.ulSamples == 0U ) {
+        return;
     }
-}
-/*-----------------------------------------------------------*/
 
-UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer )
-{
-    Timer_t * pxTimer = xTimer;
-    UBaseType_t uxReturn;
+    /* Find the buckets holding the 10th and the 99th percentile period. */
+    for( uxBucket = 0; uxBucket < 32U; uxBucket++ ) {
+        if( xPeriodStats.ulHistogram[ uxBucket ] == 0U ) {
+            continue;
+        }
 
-    configASSERT( xTimer );
-    taskENTER_CRITICAL();
-    {
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) == 0 )
-        {
-            /* Not an auto-reload timer. */
-            uxReturn = ( UBaseType_t ) pdFALSE;
+        if( ( ulSeen <= ulLowRank ) && ( ( ulSeen + xPeriodStats.ulHistogram[ uxBucket ] ) > ulLowRank ) ) {
+            uxLow = uxBucket;
         }
-        else
-        {
-            /* Is an auto-reload timer. */
-            uxReturn = ( UBaseType_t ) pdTRUE;
+
+        ulSeen += xPeriodStats.ulHistogram[ uxBucket ];
+        uxHigh = uxBucket;
+
+        if( ulSeen >= ulHighRank ) {
+            break;
         }
     }
-    taskEXIT_CRITICAL();
 
-    return uxReturn;
+    /* A slot of 1/16 of the shortest common period, rounded down to a
+     * power of two. */
+    uxBits = ( uxLow > 4U ) ? ( uxLow - 4U ) : 0U;
+    pxTuning->xWheelSlotTicks = ( TickType_t ) 1U << uxBits;
+
+    /* Enough levels to reach the top of the 99th percentile bucket. */
+    pxTuning->uxWheelLevels = ( ( uxHigh + 1U - uxBits ) + ( tmrWHEEL_LEVEL_BITS - 1U ) ) / tmrWHEEL_LEVEL_BITS;
+
+    if( ( xPeriodStats.xFrequent[ 0 ].ulCount >= 16U ) &&
+        ( xPeriodStats.xFrequent[ 0 ].ulCount >= ( xPeriodStats.ulSamples / 4U ) ) ) {
+        pxTuning->xGroupPeriod = xPeriodStats.xFrequent[ 0 ].xPeriod;
+        pxTuning->ulGroupCount = xPeriodStats.xFrequent[ 0 ].ulCount;
+    }
 }
-/*-----------------------------------------------------------*/
 
-TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer )
+#endif /* configUSE_TIMER_PERIOD_STATS */
+
+#if ( configUSE_TIMER_SNAPSHOT == 1 )
+
+/*
+ * Link pxTimer into pxList, which must already hold its expiry time, starting
+ * the sorted walk from *ppxHint rather than from the list end.  Feeding timers
+ * in ascending expiry order therefore merges them into the list in one pass.
+ */
+static void prvSnapshotInsertAfterHint( List_t * const pxList,
+                                        ListItem_t ** const ppxHint,
+                                        Timer_t * const pxTimer )
 {
-    Timer_t * pxTimer = xTimer;
-    TickType_t xReturn;
+    ListItem_t * const pxNewListItem = &( pxTimer->xTimerListItem );
+    ListItem_t * const pxEnd = ( ListItem_t * ) &( pxList->xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM. */
+    const TickType_t xValueOfInsertion = listGET_LIST_ITEM_VALUE( pxNewListItem );
+    ListItem_t * pxIterator = *ppxHint;
 
-    configASSERT( xTimer );
-    xReturn = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
-    return xReturn;
+    while( ( pxIterator->pxNext != pxEnd ) && ( pxIterator->pxNext->xItemValue <= xValueOfInsertion ) ) {
+        pxIterator = pxIterator->pxNext;
+    }
+
+    pxNewListItem->pxNext = pxIterator->pxNext;
+    pxNewListItem->pxNext->pxPrevious = pxNewListItem;
+    pxNewListItem->pxPrevious = pxIterator;
+    pxIterator->pxNext = pxNewListItem;
+    pxNewListItem->pxContainer = pxList;
+    ( pxList->uxNumberOfItems )++;
+
+    *ppxHint = pxNewListItem;
 }
 /*-----------------------------------------------------------*/
 
-const char * pcTimerGetName( TimerHandle_t xTimer ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+/*
+ * Ticks from xTimeNow until pxTimer, which is in an active list, next
+ * expires, or 0 if it is overdue.  A deadline is always one period after the
+ * tick the timer was started or reloaded from, which is not later than
+ * xTimeNow, so comparing the time since then with the period holds across a
+ * wrap of the tick count.
+ */
+static uint32_t prvSnapshotRemaining( const Timer_t * const pxTimer,
+                                      const TickType_t xTimeNow )
 {
-    Timer_t * pxTimer = xTimer;
+    const TickType_t xExpiry = prvGetTimerExpiryTime( pxTimer );
 
-    configASSERT( xTimer );
-    return pxTimer->pcTimerName;
+    if( ( TickType_t ) ( xTimeNow - ( xExpiry - pxTimer->xTimerPeriodInTicks ) ) >= pxTimer->xTimerPeriodInTicks ) {
+        return 0U;
+    }
+
+    return ( uint32_t ) ( xExpiry - xTimeNow );
 }
 
-TimerHandle_t xTimerCreate( const char * const pcTimerName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-                                    const TickType_t xTimerPeriodInTicks,
-                                    const UBaseType_t uxAutoReload,
-                                    void * const pvTimerID,
-                                    TimerCallbackFunction_t pxCallbackFunction )
+/*
+ * Write the record of pxTimer, which expires in ulExpiry ticks, unless
+ * pxGetKey leaves it out.  Returns the number of records written.
+ */
+static uint32_t prvSnapshotRecord( TimerSnapshotRecord_t * const pxRecord,
+                                   const Timer_t * const pxTimer,
+                                   const uint32_t ulExpiry,
+                                   TimerSnapshotKeyFunction_t pxGetKey )
 {
-    Timer_t * pxNewTimer;
-
-    pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of Timer_t is always a pointer to the timer's mame. */
+    uint64_t ullKey;
 
-    if( pxNewTimer != NULL ) {
-        /* Status is thus far zero as the timer is not created statically
-         * and has not been started.  The auto-reload bit may get set in
-         * prvInitialiseNewTimer. */
-        pxNewTimer->ucStatus = 0x00;
-        prvInitialiseNewTimer( pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction, pxNewTimer );
+    if( pxGetKey( ( TimerHandle_t ) pxTimer, &ullKey ) == pdFALSE ) {
+        return 0U;
     }
 
-    return pxNewTimer;
+    pxRecord->ullKey = ullKey;
+    pxRecord->ulExpiry = ulExpiry;
+    pxRecord->ulPeriod = pxTimer->xTimerPeriodInTicks;
+    pxRecord->ulFlags = ( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 ) ? tmrSNAPSHOT_AUTORELOAD : 0U;
+    pxRecord->ulReserved = 0U;
+
+    return 1U;
 }
 
+/*
+ * As prvSnapshotRecord(), but the anchor of a period group is replaced by
+ * one record per member.
+ */
+static uint32_t prvSnapshotSaveTimer( TimerSnapshotRecord_t * const pxRecord,
+                                      const Timer_t * const pxTimer,
+                                      const uint32_t ulExpiry,
+                                      TimerSnapshotKeyFunction_t pxGetKey )
+{
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        if( pxTimer->pxCallbackFunction == prvPeriodGroupCallback ) {
+            const PeriodGroup_t * const pxGroup = ( const PeriodGroup_t * ) pxTimer->pvTimerID;
+            uint32_t ulCount = 0U;
+            UBaseType_t x;
+
+            /* The group itself is not saved, its members are restored as
+             * timers of their own that keep the phase of the group.  Skip
+             * the holes left by members removed in a fan-out. */
+            for( x = 0; x < pxGroup->uxCount; x++ ) {
+                if( pxGroup->ppxMembers[ x ] != NULL ) {
+                    ulCount += prvSnapshotRecord( &( pxRecord[ ulCount ] ), pxGroup->ppxMembers[ x ], ulExpiry, pxGetKey );
+                }
+            }
+
+            return ulCount;
+        }
+    #endif /* configUSE_TIMER_PERIOD_GROUPS */
+
+    return prvSnapshotRecord( pxRecord, pxTimer, ulExpiry, pxGetKey );
+}
 /*-----------------------------------------------------------*/
 
-BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer ) {
-    BaseType_t xReturn;
-    Timer_t * pxTimer = xTimer;
+size_t xTimerSnapshotSize( void ) {
+    UBaseType_t uxTimers = listCURRENT_LIST_LENGTH( pxCurrentTimerList ) + listCURRENT_LIST_LENGTH( pxOverflowTimerList );
 
-    configASSERT( xTimer );
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        /* An upper bound, the anchors are counted as well. */
+        uxTimers += uxPeriodGroupMembers;
+    #endif
 
-    /* Is the timer in the list of active timers? */
-    if( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) == 0 ) {
-        xReturn = pdFALSE;
-    }
-    else {
-        xReturn = pdTRUE;
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+    {
+        UBaseType_t x;
+
+        for( x = 0; x < ( UBaseType_t ) configTIMER_PRIORITY_CLASSES; x++ ) {
+            uxTimers += listCURRENT_LIST_LENGTH( &( xDueTimerLists[ x ] ) );
+        }
     }
+    #endif
 
-    return xReturn;
-} /*lint !e818 Can't be pointer to const due to the typedef. */
+    return sizeof( TimerSnapshotHeader_t ) + ( ( size_t ) uxTimers * sizeof( TimerSnapshotRecord_t ) );
+}
 /*-----------------------------------------------------------*/
 
-void * pvTimerGetTimerID( const TimerHandle_t xTimer ) {
-    Timer_t * const pxTimer = xTimer;
-    void * pvReturn;
+size_t xTimerSnapshotSave( void * pvBuffer,
+                           size_t xBufferSize,
+                           uint64_t ullAnchor,
+                           TimerSnapshotKeyFunction_t pxGetKey )
+{
+    TimerSnapshotHeader_t * pxHeader = ( TimerSnapshotHeader_t * ) pvBuffer;
+    TimerSnapshotRecord_t * pxRecord = ( TimerSnapshotRecord_t * ) ( pxHeader + 1 );
+    List_t * pxLists[ 2 ];
+    BaseType_t xTimerListsWereSwitched;
+    TickType_t xTimeNow;
+    ListItem_t const * pxItem = NULL;
+    Timer_t * pxTimer;
+    uint32_t ulCount = 0;
+    UBaseType_t uxIndex;
+    UBaseType_t x;
+    BaseType_t xSorted = tmrHEAPS_IN_USE() ? pdFALSE : pdTRUE;
 
-    configASSERT( xTimer );
+    configASSERT( pvBuffer );
+    configASSERT( pxGetKey );
 
-    pvReturn = pxTimer->pvTimerID;
+    /* Sample first, a list switch changes which list is current. */
+    xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+    pxLists[ 0 ] = pxCurrentTimerList;
+    pxLists[ 1 ] = pxOverflowTimerList;
 
-    return pvReturn;
-}
-/*-----------------------------------------------------------*/
+    if( xBufferSize < xTimerSnapshotSize() ) {
+        return 0;
+    }
 
-void vTimerSetTimerID( TimerHandle_t xTimer, void * pvNewID ) {
-    Timer_t * const pxTimer = xTimer;
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        /* Timers already taken off the active lists and still waiting for
+         * their callback, possibly held back by a class budget, are due now
+         * so they come first. */
+        for( x = ( UBaseType_t ) configTIMER_PRIORITY_CLASSES; x > 0U; x-- ) {
+            for( pxItem = listGET_HEAD_ENTRY( &( xDueTimerLists[ x - 1U ] ) );
+                 pxItem != listGET_END_MARKER( &( xDueTimerLists[ x - 1U ] ) );
+                 pxItem = listGET_NEXT( pxItem ) ) {
+                ulCount += prvSnapshotSaveTimer( &( pxRecord[ ulCount ] ), ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ), 0U, pxGetKey );
+            }
+        }
+    #endif /* configUSE_TIMER_PRIORITY_CLASSES */
 
-    configASSERT( xTimer );
-    pxTimer->pvTimerID = pvNewID;
+    /* The current list followed by the overflow list is in expiry order, so
+     * the records come out sorted, overdue timers at the head of the current
+     * list all being saved as due now.  The heaps are only partially
+     * ordered. */
+    for( x = 0; x < 2U; x++ ) {
+        for( uxIndex = 0; uxIndex < listCURRENT_LIST_LENGTH( pxLists[ x ] ); uxIndex++ ) {
+            #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+                if( xHeapsInUse != pdFALSE ) {
+                    pxTimer = prvGetHeap( pxLists[ x ] )->ppxTimers[ uxIndex ];
+                }
+                else
+            #endif
+            {
+                pxItem = ( uxIndex == 0U ) ? listGET_HEAD_ENTRY( pxLists[ x ] ) : listGET_NEXT( pxItem );
+                pxTimer = ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem );
+            }
+
+            if( ( pxTimer->ucStatus & tmrSTATUS_RESET_PENDING ) != 0 ) {
+                /* Listed at its old expiry, not in order any more. */
+                xSorted = pdFALSE;
+            }
+
+            ulCount += prvSnapshotSaveTimer( &( pxRecord[ ulCount ] ), pxTimer, prvSnapshotRemaining( pxTimer, xTimeNow ), pxGetKey );
+        }
+    }
+
+    pxHeader->ulMagic = tmrSNAPSHOT_MAGIC;
+    pxHeader->usVersion = tmrSNAPSHOT_VERSION;
+    pxHeader->usFlags = ( xSorted != pdFALSE ) ? tmrSNAPSHOT_FLAG_SORTED : 0U;
+    pxHeader->ulRecordSize = ( uint32_t ) sizeof( TimerSnapshotRecord_t );
+    pxHeader->ulCount = ulCount;
+    pxHeader->ullAnchor = ullAnchor;
+
+    return sizeof( TimerSnapshotHeader_t ) + ( ( size_t ) ulCount * sizeof( TimerSnapshotRecord_t ) );
 }
+/*-----------------------------------------------------------*/
 
-BaseType_t xTimerStart( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
-    Timer_t * pxTimer = xTimer;
+UBaseType_t uxTimerSnapshotLoad( const void * pvBuffer,
+                                 size_t xBufferSize,
+                                 uint64_t ullNow,
+                                 TimerSnapshotCreateFunction_t pxCreate,
+                                 void * pvContext )
+{
+    const TimerSnapshotHeader_t * pxHeader = ( const TimerSnapshotHeader_t * ) pvBuffer;
+    const TimerSnapshotRecord_t * pxRecord;
+    ListItem_t * pxCurrentHint;
+    ListItem_t * pxOverflowHint;
     BaseType_t xTimerListsWereSwitched;
-    uint32_t xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+    BaseType_t xSorted;
+    TickType_t xTimeNow;
+    TickType_t xRemaining;
+    TickType_t xExpiry;
+    uint64_t ullElapsed;
+    Timer_t * pxTimer;
+    UBaseType_t uxRestored = 0;
+    uint32_t ul;
 
-    pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+    configASSERT( pvBuffer );
+    configASSERT( pxCreate );
 
-    if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
-        /* The timer is in a list, remove it. */
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+    if( ( xBufferSize < sizeof( TimerSnapshotHeader_t ) ) ||
+        ( pxHeader->ulMagic != tmrSNAPSHOT_MAGIC ) ||
+        ( pxHeader->usVersion != tmrSNAPSHOT_VERSION ) ||
+        ( pxHeader->ulRecordSize != ( uint32_t ) sizeof( TimerSnapshotRecord_t ) ) ||
+        ( ( ( xBufferSize - sizeof( TimerSnapshotHeader_t ) ) / sizeof( TimerSnapshotRecord_t ) ) < pxHeader->ulCount ) ) {
+        return 0;
     }
 
-    if( prvInsertTimerInActiveList( pxTimer, xTimeNow + pxTimer->xTimerPeriodInTicks, xTimeNow, xTimeNow ) != pdFALSE ) {
-        /* The timer expired before it was added to the active
-         * timer list.  Process it now. */
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 ) {
-            prvReloadTimer( pxTimer, xTimeNow + pxTimer->xTimerPeriodInTicks, xTimeNow );
+    xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+    pxCurrentHint = ( ListItem_t * ) &( pxCurrentTimerList->xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM. */
+    pxOverflowHint = ( ListItem_t * ) &( pxOverflowTimerList->xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM. */
+    xSorted = ( ( pxHeader->usFlags & tmrSNAPSHOT_FLAG_SORTED ) != 0U ) ? pdTRUE : pdFALSE;
+    ullElapsed = ( ullNow > pxHeader->ullAnchor ) ? ( ullNow - pxHeader->ullAnchor ) : 0U;
+    pxRecord = ( const TimerSnapshotRecord_t * ) ( pxHeader + 1 );
+
+    for( ul = 0; ul < pxHeader->ulCount; ul++, pxRecord++ ) {
+        if( pxRecord->ulPeriod == 0U ) {
+            continue;
+        }
+
+        pxTimer = pxCreate( pxRecord->ullKey, pxRecord->ulPeriod, ( ( pxRecord->ulFlags & tmrSNAPSHOT_AUTORELOAD ) != 0U ) ? pdTRUE : pdFALSE, pvContext );
+
+        if( pxTimer == NULL ) {
+            continue;
+        }
+
+        /* Anything that fell due while the service was down expires on the
+         * next call to dk_timer_task(). */
+        xRemaining = ( ullElapsed >= pxRecord->ulExpiry ) ? ( TickType_t ) 0U : ( TickType_t ) ( pxRecord->ulExpiry - ullElapsed );
+        xExpiry = xTimeNow + xRemaining;
+
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) {
+            prvActiveListRemove( pxTimer );
+        }
+
+        tmrLEAVE_PERIOD_GROUP( pxTimer );
+
+        tmrBEGIN_STATE_WRITE( pxTimer );
+        listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xExpiry );
+        listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+        tmrCLEAR_STATUS( pxTimer, tmrSTATUS_RESET_PENDING );
+        tmrSET_STATUS( pxTimer, tmrSTATUS_IS_ACTIVE );
+        tmrEND_STATE_WRITE( pxTimer );
+
+        if( ( xSorted == pdFALSE ) || tmrHEAPS_IN_USE() ) {
+            prvActiveListInsert( ( xExpiry < xTimeNow ) ? pxOverflowTimerList : pxCurrentTimerList, pxTimer );
+        }
+        else if( xExpiry < xTimeNow ) {
+            /* The expiry time wraps past the tick count overflow. */
+            prvSnapshotInsertAfterHint( pxOverflowTimerList, &pxOverflowHint, pxTimer );
         }
         else {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            prvSnapshotInsertAfterHint( pxCurrentTimerList, &pxCurrentHint, pxTimer );
         }
 
-        /* Call the timer callback. */
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+        uxRestored++;
     }
 
-    return pdTRUE;
-}
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+        /* The merge bypasses prvActiveListInsert(). */
+        prvCheckBackend( xTimeNow );
+    #endif
 
-BaseType_t xTimerStop( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
-    xTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-    return pdTRUE;
+    return uxRestored;
 }
 
-BaseType_t xTimerChangePeriod( TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait ) {
-    Timer_t * pxTimer = xTimer;
-    BaseType_t xTimerListsWereSwitched;
-    uint32_t xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+#endif /* configUSE_TIMER_SNAPSHOT */
 
-    pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-    pxTimer->xTimerPeriodInTicks = xNewPeriod;
-    configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+TickType_t xTimerGetExpectedIdleTime( void ) {
+    const TickType_t xTimeNow = sys_get_TickCount();
+    TickType_t xIdle = portMAX_DELAY;
+    TickType_t xExpiry;
 
-    /* The new period does not really have a reference, and can
-     * be longer or shorter than the old one.  The command time is
-     * therefore set to the current time, and as the period cannot
-     * be zero the next expiry time can only be in the future,
-     * meaning (unlike for the xTimerStart() case above) there is
-     * no fail case that needs to be handled here. */
-    ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+    if( xTimeNow < xLastTime ) {
+        /* The lists must be switched. */
+        return 0U;
+    }
 
-    return pdTRUE;
-}
+    #if ( configTIMER_QUEUE_LENGTH > 0 )
+        if( portATOMIC_LOAD_ACQUIRE_U32( &( xTimerQueue[ ulQueueHead & tmrQUEUE_INDEX_MASK ].ulSequence ) ) == ( ulQueueHead + 1U ) ) {
+            return 0U;
+        }
+    #endif
 
-BaseType_t xTimerDelete( TimerHandle_t xTimer, const TickType_t xTicksToWait ) {
-    Timer_t * pxTimer = xTimer;
-    if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 ) {
-        vPortFree( pxTimer );
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+    {
+        UBaseType_t x;
+
+        /* Timers deferred by a class budget. */
+        for( x = 0; x < ( UBaseType_t ) configTIMER_PRIORITY_CLASSES; x++ ) {
+            if( listLIST_IS_EMPTY( &( xDueTimerLists[ x ] ) ) == pdFALSE ) {
+                return 0U;
+            }
+        }
+    }
+    #endif
+
+    if( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE ) {
+        xExpiry = listGET_LIST_ITEM_VALUE( &( prvActiveListHead( pxCurrentTimerList )->xTimerListItem ) );
+
+        if( xExpiry <= xTimeNow ) {
+            return 0U;
+        }
+
+        xIdle = xExpiry - xTimeNow;
+    }
+    else if( ( listLIST_IS_EMPTY( pxOverflowTimerList ) == pdFALSE ) && ( xTimeNow != 0U ) ) {
+        /* Nothing expires before the tick count wraps and the lists are
+         * switched. */
+        xIdle = ( TickType_t ) 0U - xTimeNow;
     }
     else {
-        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+        /* No timer is running, or the overflow list is a full tick period
+         * away. */
     }
 
-    return pdTRUE;
+    #if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+        if( ulCompactHeapCount != 0U ) {
+            xExpiry = tmrCOMPACT_KEY( ulCompactHeap[ 0 ] );
+
+            if( xExpiry <= ( TickType_t ) ( xTimeNow - xCompactBase ) ) {
+                return 0U;
+            }
+
+            if( ( xExpiry - ( TickType_t ) ( xTimeNow - xCompactBase ) ) < xIdle ) {
+                xIdle = xExpiry - ( TickType_t ) ( xTimeNow - xCompactBase );
+            }
+        }
+    #endif /* configTIMER_COMPACT_POOL_SIZE */
+
+    return xIdle;
 }
+/*-----------------------------------------------------------*/
 
 void dk_timer_task(void) {
     TickType_t xNextExpireTime;
@@ -457,12 +4091,75 @@ void dk_timer_task(void) {
     BaseType_t xTimerListsWereSwitched;
     uint32_t xTimeNow;
 
+    #if ( configTIMER_QUEUE_LENGTH > 0 )
+        prvProcessReceivedCommands();
+    #endif
+
+    #if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+        xBatchCollecting = ( pxBatchCallback != NULL ) ? pdTRUE : pdFALSE;
+    #endif
+
     xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
     xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
 
+    #if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+        /* Only passes with something to do are recorded, the task may be
+         * polled far more often than timers expire. */
+        if( ( pxWorkloadWrite != NULL ) &&
+            ( ( xTimerListsWereSwitched != pdFALSE ) || ( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) ) ) ) {
+            prvWorkloadRecord( tmrWORKLOAD_OP_TASK, xTimeNow, 0U, 0U, 0U );
+        }
+    #endif
+
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+    {
+        /* Queue everything that is due, then call the callbacks in class
+         * order.  Timers expired by a list switch were queued already. */
+        if( xTimerListsWereSwitched == pdFALSE ) {
+            while( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) ) {
+                prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+            }
+        }
+
+        prvDispatchDueTimers( xTimeNow );
+    }
+    #else /* configUSE_TIMER_PRIORITY_CLASSES */
     if ( (xTimerListsWereSwitched == pdFALSE) && (xListWasEmpty == pdFALSE) && (xNextExpireTime <= xTimeNow) ) {
         prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+
+        #if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+        {
+            /* With a batch callback installed, everything that is due is
+             * processed in this pass so it can be delivered together. */
+            while( xBatchCollecting != pdFALSE ) {
+                xNextExpireTime = prvGetNextExpireTime( &xListWasEmpty );
+
+                if( ( xListWasEmpty != pdFALSE ) || ( xNextExpireTime > xTimeNow ) ) {
+                    break;
+                }
+
+                prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+            }
+        }
+        #endif /* configUSE_TIMER_BATCH_CALLBACK */
     }
+    #endif /* configUSE_TIMER_PRIORITY_CLASSES */
+
+    #if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+        if( xBatchCollecting != pdFALSE ) {
+            prvBatchFlush();
+            xBatchCollecting = pdFALSE;
+        }
+    #endif
+
+    #if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+        prvProcessExpiredCompactTimers( xTimeNow );
+    #endif
+
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+        prvCheckBackend( xTimeNow );
+    #endif
 }
 
 
@@ -13,6 +13,208 @@
 #include "dk_typedef.h"
 #include "list.h"
 
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+/* Number of timers in the internal timer pool.  When non-zero, xTimerCreate()
+ * takes timers from a static pool instead of calling pvPortMalloc(), and every
+ * pooled timer can also be addressed by a 32-bit TimerRef_t. */
+#ifndef configTIMER_POOL_SIZE
+    #define configTIMER_POOL_SIZE          0
+#endif
+
+/* Number of TimerRef_t bits used for the pool index.  The remaining upper
+ * bits hold the generation of the pool slot. */
+#ifndef configTIMER_REF_INDEX_BITS
+    #define configTIMER_REF_INDEX_BITS     20
+#endif
+
+/* Set to 1 to include xTimerSnapshotSave()/xTimerSnapshotLoad(), which
+ * persist the active timers to a flat buffer and restore them in bulk. */
+#ifndef configUSE_TIMER_SNAPSHOT
+    #define configUSE_TIMER_SNAPSHOT       0
+#endif
+
+/* Set to 1 to record timer events into a ring of fixed-size binary records,
+ * see dk_timer_trace.h and uxTimerTraceDump(). */
+#ifndef configUSE_TIMER_TRACE
+    #define configUSE_TIMER_TRACE          0
+#endif
+
+/* Number of records in the trace ring, must be a power of two. */
+#ifndef configTIMER_TRACE_BUFFER_LENGTH
+    #define configTIMER_TRACE_BUFFER_LENGTH    1024
+#endif
+
+/* Set to 1 to let the active timer lists switch from sorted linked lists to
+ * binary heaps once more than configTIMER_ADAPTIVE_HEAP_THRESHOLD timers are
+ * active, and back once fewer than configTIMER_ADAPTIVE_LIST_THRESHOLD have
+ * been active for configTIMER_ADAPTIVE_SETTLE_TICKS.  The heap arrays are
+ * allocated with pvPortMalloc() only while the heaps are in use. */
+#ifndef configUSE_TIMER_ADAPTIVE_BACKEND
+    #define configUSE_TIMER_ADAPTIVE_BACKEND    0
+#endif
+
+#ifndef configTIMER_ADAPTIVE_HEAP_THRESHOLD
+    #define configTIMER_ADAPTIVE_HEAP_THRESHOLD    256
+#endif
+
+#ifndef configTIMER_ADAPTIVE_LIST_THRESHOLD
+    #define configTIMER_ADAPTIVE_LIST_THRESHOLD    64
+#endif
+
+#ifndef configTIMER_ADAPTIVE_SETTLE_TICKS
+    #define configTIMER_ADAPTIVE_SETTLE_TICKS    1000
+#endif
+
+/* Length of the lock-free command queue behind the FromISR API, must be a
+ * power of two.  Commands are applied at the top of dk_timer_task().  Set to
+ * 0 to leave the queue and the FromISR functions out. */
+#ifndef configTIMER_QUEUE_LENGTH
+    #define configTIMER_QUEUE_LENGTH    0
+#endif
+
+/* Set to 1 to include period groups, see xTimerPeriodGroupCreate(). */
+#ifndef configUSE_TIMER_PERIOD_GROUPS
+    #define configUSE_TIMER_PERIOD_GROUPS    0
+#endif
+
+/* Set to 1 to include lazy reset, see vTimerSetLazyReset(). */
+#ifndef configUSE_TIMER_LAZY_RESET
+    #define configUSE_TIMER_LAZY_RESET    0
+#endif
+
+/* Number of compact timers, see xTimerCompactCreate().  0 leaves them out. */
+#ifndef configTIMER_COMPACT_POOL_SIZE
+    #define configTIMER_COMPACT_POOL_SIZE    0
+#endif
+
+/* Size of the compact timer callback table, at most 256. */
+#ifndef configTIMER_COMPACT_MAX_CALLBACKS
+    #define configTIMER_COMPACT_MAX_CALLBACKS    8
+#endif
+
+/* Most compact timer callbacks called by one dk_timer_task() pass.  Due
+ * timers past the limit are left for the next pass, so a burst of expiries
+ * cannot hold up the ordinary timers for long. */
+#ifndef configTIMER_COMPACT_MAX_EXPIRIES
+    #define configTIMER_COMPACT_MAX_EXPIRIES    64
+#endif
+
+/* Set to 1 to give every compact timer a void * ID, held in a side table. */
+#ifndef configTIMER_COMPACT_STORE_ID
+    #define configTIMER_COMPACT_STORE_ID    0
+#endif
+
+/* Set to 1 to keep statistics of the periods timers are created or changed
+ * with, see vTimerGetPeriodStats() and vTimerRecommendTuning(). */
+#ifndef configUSE_TIMER_PERIOD_STATS
+    #define configUSE_TIMER_PERIOD_STATS    0
+#endif
+
+/* Number of distinct periods whose counts are tracked. */
+#ifndef configTIMER_PERIOD_STATS_TOP
+    #define configTIMER_PERIOD_STATS_TOP    8
+#endif
+
+/* Set to 1 to include the batch callback, see vTimerSetBatchCallback(). */
+#ifndef configUSE_TIMER_BATCH_CALLBACK
+    #define configUSE_TIMER_BATCH_CALLBACK    0
+#endif
+
+/* Most timers passed to the batch callback in one call. */
+#ifndef configTIMER_BATCH_SIZE
+    #define configTIMER_BATCH_SIZE    32
+#endif
+
+/* Set to 1 to place USDT probes (provider dk_soft_timer, see <sys/sdt.h>)
+ * on the hot paths for perf and bpftrace: start, stop, insert, expired,
+ * reload_catchup and switch_lists.  A probe is a single nop until a tracer
+ * attaches to it, and the insert walk length is only counted while one is
+ * attached. */
+#ifndef configUSE_TIMER_USDT
+    #define configUSE_TIMER_USDT    0
+#endif
+
+/* Set to 1 to time every timer callback with portGET_RUN_TIME_COUNTER_VALUE()
+ * and keep the longest and total time per timer, see
+ * vTimerGetCallbackStats().  A callback that runs for longer than
+ * configTIMER_CALLBACK_BUDGET counter units is reported to
+ * vApplicationTimerOverrunHook(), which the application must provide. */
+#ifndef configUSE_TIMER_CALLBACK_BUDGET
+    #define configUSE_TIMER_CALLBACK_BUDGET    0
+#endif
+
+/* Callback budget, in portGET_RUN_TIME_COUNTER_VALUE() units. */
+#ifndef configTIMER_CALLBACK_BUDGET
+    #define configTIMER_CALLBACK_BUDGET    1000000UL
+#endif
+
+/* Set to 1 to make xTimerIsTimerActive(), xTimerGetExpiryTime() and
+ * xTimerGetPeriod() safe to call from other threads while dk_timer_task() is
+ * running.  Every timer then carries a sequence counter that the timer service
+ * makes odd while it changes the expiry state of the timer.  Readers retry
+ * instead of locking, so they never hold up the timer service. */
+#ifndef configUSE_TIMER_CONCURRENT_READS
+    #define configUSE_TIMER_CONCURRENT_READS    0
+#endif
+
+/* Set to 1 to include timers whose callback returns the next delay, see
+ * xTimerCreateRescheduling(). */
+#ifndef configUSE_TIMER_RESCHEDULE
+    #define configUSE_TIMER_RESCHEDULE    0
+#endif
+
+/* Set to 1 to include retry timers with exponential backoff, see
+ * xTimerCreateBackoff(). */
+#ifndef configUSE_TIMER_BACKOFF
+    #define configUSE_TIMER_BACKOFF    0
+#endif
+
+/* Set to 1 to dispatch due timers in priority class order, see
+ * vTimerSetPriorityClass(). */
+#ifndef configUSE_TIMER_PRIORITY_CLASSES
+    #define configUSE_TIMER_PRIORITY_CLASSES    0
+#endif
+
+/* Number of priority classes, at most 256. */
+#ifndef configTIMER_PRIORITY_CLASSES
+    #define configTIMER_PRIORITY_CLASSES    4
+#endif
+
+/* Set to 1 to include timer groups, see xTimerGroupCreate(). */
+#ifndef configUSE_TIMER_GROUPS
+    #define configUSE_TIMER_GROUPS    0
+#endif
+
+/* Set to 1 to include the pending expiry iterator, see vTimerIteratorInit(). */
+#ifndef configUSE_TIMER_ITERATOR
+    #define configUSE_TIMER_ITERATOR    0
+#endif
+
+/* Heap positions an iterator can hold while it walks the heaps, see
+ * TimerIterator_t.  0 makes every step of such a walk a scan. */
+#ifndef configTIMER_ITERATOR_FRONTIER
+    #define configTIMER_ITERATOR_FRONTIER    16
+#endif
+
+/* Set to 1 to include workload recording, see vTimerWorkloadRecordStart(). */
+#ifndef configUSE_TIMER_WORKLOAD_RECORD
+    #define configUSE_TIMER_WORKLOAD_RECORD    0
+#endif
+
+/* Number of records buffered before they are passed to the write function. */
+#ifndef configTIMER_WORKLOAD_BUFFER_LENGTH
+    #define configTIMER_WORKLOAD_BUFFER_LENGTH    256
+#endif
+
+/* A constant counter would make every callback take no time and every trace
+ * record carry the same stamp. */
+#if ( ( configUSE_TIMER_TRACE == 1 ) || ( configUSE_TIMER_CALLBACK_BUDGET == 1 ) ) && !defined( portGET_RUN_TIME_COUNTER_VALUE )
+    #error "configUSE_TIMER_TRACE and configUSE_TIMER_CALLBACK_BUDGET need portGET_RUN_TIME_COUNTER_VALUE(), define it in the port."
+#endif
+
 struct tmrTimerControl;
 typedef struct tmrTimerControl * TimerHandle_t;
 #define xTimerHandle            TimerHandle_t
@@ -20,10 +222,143 @@ typedef struct tmrTimerControl * TimerHandle_t;
 typedef void (* TimerCallbackFunction_t)( TimerHandle_t xTimer );
 typedef uint32_t (* getSysTickCount_t)();
 
+/* Defines the prototype to which functions used with the
+ * xTimerPendFunctionCallFromISR() function must conform. */
+typedef void (* PendedFunction_t)( void *, uint32_t );
+
+/*
+ * Compact reference to a pooled timer: the pool index in the low
+ * configTIMER_REF_INDEX_BITS bits and the slot generation above it.  Deleting
+ * a timer bumps the generation of its slot, so a stale reference is detected
+ * by a single compare instead of touching a timer that may have been reused.
+ */
+typedef uint32_t TimerRef_t;
+#define tmrINVALID_TIMER_REF    ( ( TimerRef_t ) 0U )
+
+#if ( configUSE_TIMER_SNAPSHOT == 1 )
+
+/*
+ * Snapshot layout: one TimerSnapshotHeader_t followed by ulCount records.
+ * Expiry times are stored relative to ullAnchor, a wall-clock time in ticks
+ * supplied by the application, because the tick count itself does not
+ * survive a restart.  The file is written in native byte order.
+ */
+#define tmrSNAPSHOT_MAGIC           ( ( uint32_t ) 0x53544b44UL ) /* "DKTS" */
+#define tmrSNAPSHOT_VERSION         ( ( uint16_t ) 1U )
+#define tmrSNAPSHOT_FLAG_SORTED     ( ( uint16_t ) 0x0001U )     /* Records are in expiry order. */
+#define tmrSNAPSHOT_AUTORELOAD      ( ( uint32_t ) 0x00000001UL )
+
+typedef struct xTIMER_SNAPSHOT_HEADER
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint16_t usFlags;
+    uint32_t ulRecordSize;
+    uint32_t ulCount;
+    uint64_t ullAnchor;
+} TimerSnapshotHeader_t;
+
+typedef struct xTIMER_SNAPSHOT_RECORD
+{
+    uint64_t ullKey;        /*<< Application key, see TimerSnapshotKeyFunction_t. */
+    uint32_t ulExpiry;      /*<< Ticks from ullAnchor to the next expiry, 0 if it was overdue. */
+    uint32_t ulPeriod;
+    uint32_t ulFlags;       /*<< tmrSNAPSHOT_AUTORELOAD. */
+    uint32_t ulReserved;
+} TimerSnapshotRecord_t;
+
+/* Return pdTRUE and set *pullKey to persist xTimer, or pdFALSE to leave it
+ * out of the snapshot. */
+typedef BaseType_t (* TimerSnapshotKeyFunction_t)( TimerHandle_t xTimer, uint64_t * pullKey );
+
+/* Create (but do not start) the timer for a restored record, or return NULL
+ * to drop it. */
+typedef TimerHandle_t (* TimerSnapshotCreateFunction_t)( uint64_t ullKey,
+                                                        TickType_t xPeriod,
+                                                        UBaseType_t uxAutoReload,
+                                                        void * pvContext );
+
+#endif /* configUSE_TIMER_SNAPSHOT */
+
+/*
+ * In line with FreeRTOS, the timer structure is not exposed to the application.
+ * StaticTimer_t has the same size and alignment as the real structure so the
+ * application can provide the memory for a timer itself (for example inside
+ * another object) and create it with xTimerCreateStatic() without any call to
+ * pvPortMalloc().
+ */
+typedef struct xSTATIC_TIMER
+{
+    void * pvDummy1;
+    ListItem_t xDummy2;
+    TickType_t xDummy3;
+    void * pvDummy4;
+    void * pvDummy5;
+    uint8_t ucDummy6;
+    #if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+        UBaseType_t uxDummy7;
+    #endif
+    #if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+        void * pvDummy8;
+        UBaseType_t uxDummy9;
+    #endif
+    #if ( configUSE_TIMER_LAZY_RESET == 1 )
+        TickType_t xDummy10;
+    #endif
+    #if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+        uint32_t ulDummy11;
+        uint64_t ullDummy12;
+    #endif
+    #if ( configUSE_TIMER_CONCURRENT_READS == 1 )
+        uint32_t ulDummy13;
+    #endif
+    #if ( configUSE_TIMER_GROUPS == 1 )
+        ListItem_t xDummy14;
+    #endif
+    #if ( configUSE_TIMER_BACKOFF == 1 )
+        const void * pvDummy15;
+        TickType_t xDummy16;
+    #endif
+    #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+        uint8_t ucDummy17;
+    #endif
+    #if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+        uint32_t ulDummy18;
+    #endif
+} StaticTimer_t;
+
+/* IDs for commands that can be sent/received on the timer queue.  These are to
+ * be used solely through the macros that make up the public software timer
+ * API, as defined below. */
+#define tmrCOMMAND_EXECUTE_CALLBACK_FROM_ISR    ( ( BaseType_t ) -2 )
+#define tmrCOMMAND_EXECUTE_CALLBACK             ( ( BaseType_t ) -1 )
+#define tmrCOMMAND_START_FROM_ISR            ( ( BaseType_t ) 6 )
+#define tmrCOMMAND_RESET_FROM_ISR            ( ( BaseType_t ) 7 )
+#define tmrCOMMAND_STOP_FROM_ISR             ( ( BaseType_t ) 8 )
+#define tmrCOMMAND_CHANGE_PERIOD_FROM_ISR    ( ( BaseType_t ) 9 )
+
+/* Structures that can hold the active timers, see xTimerSetBackend(). */
+#define tmrBACKEND_ADAPTIVE     ( ( UBaseType_t ) 0U )
+#define tmrBACKEND_LIST         ( ( UBaseType_t ) 1U )
+#define tmrBACKEND_HEAP         ( ( UBaseType_t ) 2U )
+
 TickType_t xTimerGetPeriod( TimerHandle_t xTimer );
 void vTimerSetReloadMode( TimerHandle_t xTimer,
                           const UBaseType_t uxAutoReload );
 UBaseType_t uxTimerGetReloadMode( TimerHandle_t xTimer );
+
+#if ( configUSE_TIMER_LAZY_RESET == 1 )
+
+/*
+ * With lazy reset enabled, restarting a timer that is already running only
+ * records the new deadline, which is O(1).  The timer keeps its old place in
+ * the active list and is moved to the recorded deadline once, when that old
+ * place comes due.  Meant for timeouts that are pushed back far more often
+ * than they fire, such as an idle timer reset on every received packet.
+ */
+    void vTimerSetLazyReset( TimerHandle_t xTimer,
+                             const UBaseType_t uxLazyReset );
+#endif
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer );
 const char * pcTimerGetName( TimerHandle_t xTimer );
 TimerHandle_t xTimerCreate( const char * const pcTimerName,
@@ -31,16 +366,527 @@ TimerHandle_t xTimerCreate( const char * const pcTimerName,
                                     const UBaseType_t uxAutoReload,
                                     void * const pvTimerID,
                                     TimerCallbackFunction_t pxCallbackFunction );
+TimerHandle_t xTimerCreateStatic( const char * const pcTimerName,
+                                  const TickType_t xTimerPeriodInTicks,
+                                  const UBaseType_t uxAutoReload,
+                                  void * const pvTimerID,
+                                  TimerCallbackFunction_t pxCallbackFunction,
+                                  StaticTimer_t * pxTimerBuffer );
 BaseType_t xTimerIsTimerActive( TimerHandle_t xTimer );
 void * pvTimerGetTimerID( const TimerHandle_t xTimer );
 void vTimerSetTimerID( TimerHandle_t xTimer, void * pvNewID );
 BaseType_t xTimerStart( TimerHandle_t xTimer, const TickType_t xTicksToWait );
 BaseType_t xTimerStop( TimerHandle_t xTimer, const TickType_t xTicksToWait );
 BaseType_t xTimerChangePeriod( TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait );
+BaseType_t xTimerDelete( TimerHandle_t xTimer, const TickType_t xTicksToWait );
+
+#if ( configUSE_TIMER_RESCHEDULE == 1 )
+
+/* Returned by a TimerRescheduleFunction_t to leave the timer stopped. */
+    #define tmrRESCHEDULE_STOP    ( ( TickType_t ) 0U )
+
+    typedef TickType_t (* TimerRescheduleFunction_t)( TimerHandle_t xTimer );
+
+/*
+ * Create a one-shot timer whose callback picks the delay to its next expiry.
+ * The value returned by pxRescheduleFunction becomes the period of the timer
+ * and the timer is restarted that many ticks after the tick it was processed
+ * at, with a single insert and no further read of the tick count.  Return
+ * tmrRESCHEDULE_STOP to leave it stopped.
+ *
+ * A callback that starts, stops or changes the period of its own timer
+ * overrides the returned value, only a timer left stopped by its callback is
+ * restarted.  A callback that deletes its own timer must return
+ * tmrRESCHEDULE_STOP.  The return value is ignored when the timer expires as
+ * a member of a period group.
+ */
+    TimerHandle_t xTimerCreateRescheduling( const char * const pcTimerName,
+                                            const TickType_t xFirstDelayInTicks,
+                                            void * const pvTimerID,
+                                            TimerRescheduleFunction_t pxRescheduleFunction );
+    TimerHandle_t xTimerCreateReschedulingStatic( const char * const pcTimerName,
+                                                  const TickType_t xFirstDelayInTicks,
+                                                  void * const pvTimerID,
+                                                  TimerRescheduleFunction_t pxRescheduleFunction,
+                                                  StaticTimer_t * pxTimerBuffer );
+
+#endif /* configUSE_TIMER_RESCHEDULE */
+
+#if ( configUSE_TIMER_BACKOFF == 1 )
+
+/* Growth of the delay of a backoff timer.  Usually shared by many timers,
+ * it must stay valid while they exist. */
+    typedef struct xTIMER_BACKOFF_POLICY
+    {
+        TickType_t xBaseTicks;   /*<< Delay before the first retry. */
+        TickType_t xCapTicks;    /*<< Longest delay, the growth stops there. */
+        uint16_t usMultiplier;   /*<< Growth per retry, 8.8 fixed point: 0x0200 doubles the delay. */
+        uint8_t ucJitterPercent; /*<< Each delay is shortened by a random 0 to ucJitterPercent percent, at most 100. */
+    } TimerBackoffPolicy_t;
+
+/*
+ * Create a retry timer.  Once started it expires after about xBaseTicks and
+ * then keeps expiring, each delay usMultiplier / 256 times the previous one
+ * up to xCapTicks, until it is stopped.  The timer is rearmed before its
+ * callback is called, from the tick it was processed at, so a retry costs
+ * one insert and no API call; the callback only stops the timer once the
+ * retry has succeeded.  Stopping the timer starts a new series at
+ * xBaseTicks.
+ *
+ * Every delay, the first one included, is shortened by the jitter before it
+ * is used, so timers started on the same tick do not retry on the same
+ * ticks.  The jitter does not carry over, each delay grows from the one
+ * before it was shortened.  xTimerGetPeriod() returns the delay after
+ * jitter.
+ */
+    TimerHandle_t xTimerCreateBackoff( const char * const pcTimerName,
+                                       const TimerBackoffPolicy_t * pxPolicy,
+                                       void * const pvTimerID,
+                                       TimerCallbackFunction_t pxCallbackFunction );
+    TimerHandle_t xTimerCreateBackoffStatic( const char * const pcTimerName,
+                                             const TimerBackoffPolicy_t * pxPolicy,
+                                             void * const pvTimerID,
+                                             TimerCallbackFunction_t pxCallbackFunction,
+                                             StaticTimer_t * pxTimerBuffer );
+
+/* Seed the generator behind the jitter, for example from a hardware random
+ * number generator, so that devices booted together do not draw the same
+ * jitter.  0 is replaced by a fixed value. */
+    void vTimerSetBackoffSeed( uint32_t ulSeed );
+
+#endif /* configUSE_TIMER_BACKOFF */
+
+#if ( configTIMER_POOL_SIZE > 0 )
+    TimerRef_t xTimerGetRef( TimerHandle_t xTimer );
+    TimerHandle_t xTimerFromRef( TimerRef_t xRef );
+    BaseType_t xTimerStartByRef( TimerRef_t xRef, const TickType_t xTicksToWait );
+    BaseType_t xTimerStopByRef( TimerRef_t xRef, const TickType_t xTicksToWait );
+    BaseType_t xTimerDeleteByRef( TimerRef_t xRef, const TickType_t xTicksToWait );
+#endif
+
+#if ( configTIMER_COMPACT_POOL_SIZE > 0 )
+
+/*
+ * Compact timers, for applications that need millions of timers.  They are
+ * addressed only by TimerRef_t, have no name, and share a small table of
+ * callbacks instead of holding a callback pointer each.  A compact timer
+ * costs a 16-byte record plus a 4-byte slot in the heap of 32-bit indices
+ * that orders the running ones, against roughly 80 bytes (plus allocator
+ * overhead) for a Timer_t on a 64-bit host.  The optional void * ID lives
+ * in a side table, see configTIMER_COMPACT_STORE_ID.
+ *
+ * Compact timers are driven by dk_timer_task() together with the ordinary
+ * timers, each pass calling up to configTIMER_COMPACT_MAX_EXPIRIES of their
+ * callbacks in expiry order.  configTIMER_REF_INDEX_BITS must leave room
+ * for the pool index, for example 24 bits for up to 16M timers.
+ */
+    typedef void (* CompactTimerCallbackFunction_t)( TimerRef_t xRef );
+
+    /* Returns the index to pass to xTimerCompactCreate(). */
+    UBaseType_t uxTimerCompactRegisterCallback( CompactTimerCallbackFunction_t pxCallbackFunction );
+
+    /* Returns tmrINVALID_TIMER_REF if the pool is exhausted. */
+    TimerRef_t xTimerCompactCreate( const TickType_t xTimerPeriodInTicks,
+                                    const UBaseType_t uxAutoReload,
+                                    const UBaseType_t uxCallbackIndex );
+
+    /* These return pdFALSE if xRef refers to a deleted timer. */
+    BaseType_t xTimerCompactStart( TimerRef_t xRef );
+    BaseType_t xTimerCompactStop( TimerRef_t xRef );
+    BaseType_t xTimerCompactChangePeriod( TimerRef_t xRef,
+                                          TickType_t xNewPeriod );
+    BaseType_t xTimerCompactDelete( TimerRef_t xRef );
+    BaseType_t xTimerCompactIsTimerActive( TimerRef_t xRef );
+
+    #if ( configTIMER_COMPACT_STORE_ID == 1 )
+        void * pvTimerCompactGetTimerID( TimerRef_t xRef );
+        void vTimerCompactSetTimerID( TimerRef_t xRef,
+                                      void * pvNewID );
+    #endif
+
+#endif /* configTIMER_COMPACT_POOL_SIZE */
+
+#if ( configUSE_TIMER_PERIOD_GROUPS == 1 )
+
+/*
+ * A period group is a single auto-reload scheduling entry shared by any
+ * number of timers with the same period and phase.  When it expires the
+ * callbacks of all its members are called in turn, so N members cost one
+ * reinsertion per period instead of N.
+ *
+ * xTimerPeriodGroupAdd() takes the timer out of the active lists (or out of
+ * its previous group), sets its period to that of the group and marks it
+ * active; it expires in phase with the group, which starts running when its
+ * first member is added.  xTimerStart(), xTimerStop(), xTimerChangePeriod()
+ * and xTimerDelete() remove a timer from its group in O(1) before doing
+ * anything else.  A one-shot member leaves the group when it expires.
+ *
+ * A snapshot saves every member as a timer of its own, expiring with the
+ * group; the group itself is not saved.  A member callback must not delete
+ * the group it belongs to.  With configUSE_TIMER_CONCURRENT_READS a deleted
+ * group is kept for the next xTimerPeriodGroupCreate() instead of being
+ * freed, so other threads may read the expiry time of a member while its
+ * group is deleted.
+ */
+    typedef struct tmrPeriodGroup * PeriodGroupHandle_t;
+
+    PeriodGroupHandle_t xTimerPeriodGroupCreate( const char * const pcGroupName,
+                                                 const TickType_t xPeriodInTicks );
+    BaseType_t xTimerPeriodGroupAdd( PeriodGroupHandle_t xGroup,
+                                     TimerHandle_t xTimer );
+    UBaseType_t uxTimerPeriodGroupGetCount( PeriodGroupHandle_t xGroup );
+    void vTimerPeriodGroupDelete( PeriodGroupHandle_t xGroup );
+
+#endif /* configUSE_TIMER_PERIOD_GROUPS */
+
+#if ( configTIMER_QUEUE_LENGTH > 0 )
+
+/*
+ * Queue a command for the timer service.  Safe to call from interrupts,
+ * signal handlers and any thread: it never blocks and never takes a lock.
+ * The command is applied by the next dk_timer_task(), using the tick count
+ * sampled here as the command time.  Returns pdFALSE if the queue is full.
+ * *pxHigherPriorityTaskWoken is kept for FreeRTOS compatibility.
+ */
+    BaseType_t xTimerGenericCommandFromISR( TimerHandle_t xTimer,
+                                            const BaseType_t xCommandID,
+                                            const TickType_t xOptionalValue,
+                                            BaseType_t * const pxHigherPriorityTaskWoken );
+
+    #define xTimerStartFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    xTimerGenericCommandFromISR( ( xTimer ), tmrCOMMAND_START_FROM_ISR, 0U, ( pxHigherPriorityTaskWoken ) )
+
+    #define xTimerStopFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    xTimerGenericCommandFromISR( ( xTimer ), tmrCOMMAND_STOP_FROM_ISR, 0U, ( pxHigherPriorityTaskWoken ) )
+
+    #define xTimerChangePeriodFromISR( xTimer, xNewPeriod, pxHigherPriorityTaskWoken ) \
+    xTimerGenericCommandFromISR( ( xTimer ), tmrCOMMAND_CHANGE_PERIOD_FROM_ISR, ( xNewPeriod ), ( pxHigherPriorityTaskWoken ) )
+
+    #define xTimerResetFromISR( xTimer, pxHigherPriorityTaskWoken ) \
+    xTimerGenericCommandFromISR( ( xTimer ), tmrCOMMAND_RESET_FROM_ISR, 0U, ( pxHigherPriorityTaskWoken ) )
+
+/*
+ * Defer the call xFunctionToPend( pvParameter1, ulParameter2 ) to the timer
+ * service.  Pended functions share the command queue with the FromISR timer
+ * commands and run from dk_timer_task(), in order, in the same context as
+ * timer callbacks, so they must not block.  Posting never blocks either:
+ * xTicksToWait is ignored like everywhere else in this port and pdFALSE is
+ * returned if the queue is full.
+ */
+    BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend,
+                                              void * pvParameter1,
+                                              uint32_t ulParameter2,
+                                              BaseType_t * pxHigherPriorityTaskWoken );
+
+    BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend,
+                                       void * pvParameter1,
+                                       uint32_t ulParameter2,
+                                       TickType_t xTicksToWait );
+
+#endif /* configTIMER_QUEUE_LENGTH */
+
+#if ( configUSE_TIMER_BATCH_CALLBACK == 1 )
+
+/*
+ * Timers created with a NULL callback function are not called one by one.
+ * Instead dk_timer_task() processes every timer that is due and passes the
+ * expired ones to the batch callback, up to configTIMER_BATCH_SIZE at a time,
+ * so they can be handled in one loop without an indirect call each.  An
+ * auto-reload timer that missed several periods appears once per expiry.
+ *
+ * Expiries keep their order with respect to ordinary callbacks: the pending
+ * batch is delivered before any ordinary callback is called.  Expiries that
+ * happen outside the collection, for example in xTimerStart() or in the
+ * batch callback itself, are delivered at once in a batch of one.
+ *
+ * The array is only valid during the call.  The batch callback may stop,
+ * restart or delete the timers in it; a timer it deletes must be skipped if
+ * it appears again further on.
+ */
+    typedef void (* TimerBatchCallbackFunction_t)( TimerHandle_t * pxTimers,
+                                                   UBaseType_t uxCount );
+
+    void vTimerSetBatchCallback( TimerBatchCallbackFunction_t pxBatchCallback );
+
+#endif /* configUSE_TIMER_BATCH_CALLBACK */
+
+#if ( configUSE_TIMER_CALLBACK_BUDGET == 1 )
+
+/*
+ * Longest and total time spent in the callback of xTimer since it was created
+ * or its statistics were last reset, in portGET_RUN_TIME_COUNTER_VALUE()
+ * units.  Timers delivered through the batch callback and compact timers are
+ * not timed.  A period group anchor includes the time of its members.
+ */
+    void vTimerGetCallbackStats( TimerHandle_t xTimer,
+                                 uint32_t * pulMaxTime,
+                                 uint64_t * pullTotalTime );
+    void vTimerResetCallbackStats( TimerHandle_t xTimer );
+
+/*
+ * Called from dk_timer_task(), straight after a callback returns, when the
+ * callback ran for more than configTIMER_CALLBACK_BUDGET.  If the callback
+ * deleted its own timer xTimer is NULL; pcTimerName was read from the timer
+ * before the call.
+ */
+    extern void vApplicationTimerOverrunHook( TimerHandle_t xTimer,
+                                              const char * pcTimerName,
+                                              uint32_t ulDuration );
+
+#endif /* configUSE_TIMER_CALLBACK_BUDGET */
+
+#if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+
+/*
+ * Every timer belongs to a priority class, from 0 (the default) to
+ * configTIMER_PRIORITY_CLASSES - 1.  As with task priorities, a higher class
+ * is more urgent.  Each dk_timer_task() pass first takes every due timer out
+ * of the active lists into a FIFO per class, then calls the callbacks class
+ * by class from the highest, so a latency-critical timer is not queued
+ * behind bulk housekeeping that came due on the same tick.
+ *
+ * vTimerSetClassBudget() limits the number of callbacks a pass may have
+ * made, counting those of higher classes, before it stops calling the
+ * callbacks of uxClass.  Under overload the rest of that class waits, still
+ * due, for the next pass, while the higher classes keep their latency.  A
+ * budget of 0, the default, is unlimited.  Timers waiting for a later pass
+ * are returned by the iterator and saved in a snapshot as due now.
+ *
+ * Members of a period group are called in the class of the group.
+ */
+    void vTimerSetPriorityClass( TimerHandle_t xTimer,
+                                 UBaseType_t uxClass );
+    UBaseType_t uxTimerGetPriorityClass( TimerHandle_t xTimer );
+    void vTimerSetClassBudget( UBaseType_t uxClass,
+                               UBaseType_t uxMaxCallbacks );
+
+#endif /* configUSE_TIMER_PRIORITY_CLASSES */
+
+#if ( configUSE_TIMER_GROUPS == 1 )
+
+/*
+ * A timer group ties together timers that are torn down together, such as
+ * the timeouts of one client connection.  A timer joins a group with
+ * xTimerGroupAdd(), normally straight after it is created, and stays a member
+ * until it is deleted or moved to another group.  Members are linked through
+ * a list item embedded in the timer, so joining and leaving are O(1) and do
+ * not allocate.
+ *
+ * xTimerGroupStop() stops every member and xTimerGroupDelete() deletes every
+ * member and then the group, each in one call.  Every member is unlinked from
+ * the active lists directly, with no search, so the cost is one O(1) unlink
+ * per running member (O(log n) while the heap backend is active).
+ *
+ * Unlike a period group, a timer group does not change when its members
+ * expire.
+ */
+    typedef struct tmrTimerGroup * TimerGroupHandle_t;
+
+/* Same size and alignment as a timer group, see xTimerGroupCreateStatic(). */
+    typedef struct xSTATIC_TIMER_GROUP
+    {
+        List_t xDummy1;
+        uint8_t ucDummy2;
+    } StaticTimerGroup_t;
+
+    TimerGroupHandle_t xTimerGroupCreate( void );
+    TimerGroupHandle_t xTimerGroupCreateStatic( StaticTimerGroup_t * pxGroupBuffer );
+
+/*
+ * Make xTimer a member of xGroup, taking it out of any other group first.  A
+ * NULL group just takes it out of its current one.  The timer keeps running
+ * or stopped as it was.
+ */
+    void vTimerGroupAdd( TimerGroupHandle_t xGroup,
+                         TimerHandle_t xTimer );
+    UBaseType_t uxTimerGroupGetCount( TimerGroupHandle_t xGroup );
+
+/* Stop every member.  The members stay in the group. */
+    BaseType_t xTimerGroupStop( TimerGroupHandle_t xGroup );
+
+/*
+ * Delete every member, then the group itself.  Can be called from the
+ * callback of a member.
+ */
+    BaseType_t xTimerGroupDelete( TimerGroupHandle_t xGroup );
+
+#endif /* configUSE_TIMER_GROUPS */
+
+#if ( configUSE_TIMER_ITERATOR == 1 )
+
+/*
+ * Walk the active timers that expire within xWithinTicks of now, first to
+ * expire first, across tick wraparound:
+ *
+ *     TimerIterator_t xIterator;
+ *     TimerHandle_t xTimer;
+ *     TickType_t xRemaining;
+ *
+ *     vTimerIteratorInit( &xIterator, 100 );
+ *     while( xTimerIteratorNext( &xIterator, &xTimer, &xRemaining ) != pdFALSE ) {
+ *         ...
+ *     }
+ *
+ * xRemaining is the number of ticks until the timer expires, counted from
+ * the tick vTimerIteratorInit() was called at, and 0 for a timer that is due
+ * but not yet processed.  Pass portMAX_DELAY to walk every active timer.
+ *
+ * The iterator points into the active lists and copies nothing, so no timer
+ * may be started, stopped, changed or deleted, and dk_timer_task() must not
+ * run, until the walk is over.  While the heaps are in use the iterator keeps
+ * the heap positions that may come next in a small min-heap of its own, so a
+ * step costs O(log k) for k timers returned.  Should that fill up, which
+ * takes more than configTIMER_ITERATOR_FRONTIER timers within the window,
+ * the rest of the heap is walked by scanning the timers within xWithinTicks
+ * on every step.
+ *
+ * Timers already taken out of the active lists to have their callback
+ * called later in the pass, see vTimerSetPriorityClass(), are returned
+ * first, as due, in the order they will be called.  Members of a period
+ * group are returned in place of the group.  A timer with a pending lazy
+ * reset is returned at the place it still holds in the active list, with the
+ * remaining time of its actual deadline.  Compact timers are not included.
+ */
+    typedef struct xTIMER_ITERATOR
+    {
+        TickType_t xTimeNow;
+        TickType_t xWithinTicks;
+        BaseType_t xWrapped;        /*<< The tick count wrapped after the lists were last switched. */
+        UBaseType_t uxPass;         /*<< 0 for the current list, 1 for the overflow list, 2 once done. */
+        ListItem_t * pxNextItem;    /*<< Next list item to visit while the lists are in use. */
+        UBaseType_t uxHeapIndex;    /*<< Heap position and key of the timer returned last while the heaps are in use. */
+        TickType_t xHeapKey;
+        #if ( configTIMER_ITERATOR_FRONTIER > 0 )
+            BaseType_t xFrontierFull;                           /*<< The frontier overflowed, the rest of the heap is scanned. */
+            UBaseType_t uxFrontierCount;
+            UBaseType_t uxFrontier[ configTIMER_ITERATOR_FRONTIER ]; /*<< Positions within the window not returned yet whose parent was, as a min-heap. */
+        #endif
+        #if ( configUSE_TIMER_PRIORITY_CLASSES == 1 )
+            UBaseType_t uxDueClass; /*<< One more than the class whose due timers are being returned, 0 once they all were. */
+        #endif
+        void * pvGroup;             /*<< Period group whose members are being returned, or NULL. */
+        UBaseType_t uxMember;
+        TickType_t xGroupRemaining;
+    } TimerIterator_t;
+
+    void vTimerIteratorInit( TimerIterator_t * pxIterator,
+                             TickType_t xWithinTicks );
+    BaseType_t xTimerIteratorNext( TimerIterator_t * pxIterator,
+                                   TimerHandle_t * pxTimer,
+                                   TickType_t * pxRemainingTicks );
+
+#endif /* configUSE_TIMER_ITERATOR */
+
+#if ( configUSE_TIMER_WORKLOAD_RECORD == 1 )
+
+/*
+ * Record the calls made to the timer service so they can be replayed against
+ * another build with tools/dk_replay.c.  While recording, every create,
+ * start, stop, change-period and delete, every dk_timer_task() pass that
+ * finds a timer due and every expiry is appended as a TimerWorkloadRecord_t
+ * (see dk_timer_workload.h).  Records are buffered and passed to pxWrite, in
+ * task context, configTIMER_WORKLOAD_BUFFER_LENGTH at a time.  The header is
+ * written by vTimerWorkloadRecordStart() itself.
+ *
+ * FromISR commands are recorded when dk_timer_task() applies them.  Period
+ * group membership and compact timers are not recorded.
+ */
+    typedef void (* TimerWorkloadWriteFunction_t)( const void * pvData,
+                                                   size_t xLength,
+                                                   void * pvContext );
+
+    void vTimerWorkloadRecordStart( TimerWorkloadWriteFunction_t pxWrite,
+                                    void * pvContext );
+    void vTimerWorkloadRecordFlush( void );
+    void vTimerWorkloadRecordStop( void );
+
+#endif /* configUSE_TIMER_WORKLOAD_RECORD */
+
+#if ( configUSE_TIMER_ADAPTIVE_BACKEND == 1 )
+    BaseType_t xTimerSetBackend( UBaseType_t uxNewBackend );
+    UBaseType_t uxTimerGetActiveBackend( void );
+#endif
+
+#if ( configUSE_TIMER_TRACE == 1 )
+    size_t uxTimerTraceDump( void * pvBuffer, size_t xBufferSize );
+    void vTimerTraceClear( void );
+#endif
+
+#if ( configUSE_TIMER_PERIOD_STATS == 1 )
+
+/*
+ * Periods requested through xTimerCreate(), xTimerCreateStatic(),
+ * xTimerChangePeriod() and their compact timer equivalents.  ulHistogram[ b ]
+ * counts periods in [ 2^b, 2^(b+1) ).  xFrequent holds the most frequent
+ * exact periods, most frequent first; the counts are upper bounds once more
+ * than configTIMER_PERIOD_STATS_TOP distinct periods have been seen.
+ */
+    typedef struct xTIMER_PERIOD_STATS
+    {
+        uint32_t ulSamples;
+        TickType_t xMinPeriod;
+        TickType_t xMaxPeriod;
+        uint32_t ulHistogram[ 32 ];
+        struct
+        {
+            TickType_t xPeriod;
+            uint32_t ulCount;
+        } xFrequent[ configTIMER_PERIOD_STATS_TOP ];
+    } TimerPeriodStats_t;
+
+/*
+ * Configuration suggested by the period statistics.
+ *
+ * xWheelSlotTicks and uxWheelLevels size a hierarchical timing wheel with 64
+ * slots per level: the slot width keeps the rounding error of nine timers in
+ * ten within about 1/16 of their period, and the levels cover 99% of the
+ * periods seen.  They are 0 while nothing has been sampled.
+ *
+ * xGroupPeriod is a period shared by at least a quarter of the samples (and
+ * by at least 16), worth turning into a period group, or 0.
+ */
+    typedef struct xTIMER_TUNING
+    {
+        TickType_t xWheelSlotTicks;
+        UBaseType_t uxWheelLevels;
+        TickType_t xGroupPeriod;
+        uint32_t ulGroupCount;
+    } TimerTuning_t;
+
+    void vTimerGetPeriodStats( TimerPeriodStats_t * pxStats );
+    void vTimerResetPeriodStats( void );
+    void vTimerRecommendTuning( TimerTuning_t * pxTuning );
+
+#endif /* configUSE_TIMER_PERIOD_STATS */
+
+#if ( configUSE_TIMER_SNAPSHOT == 1 )
+    size_t xTimerSnapshotSize( void );
+    size_t xTimerSnapshotSave( void * pvBuffer,
+                               size_t xBufferSize,
+                               uint64_t ullAnchor,
+                               TimerSnapshotKeyFunction_t pxGetKey );
+    UBaseType_t uxTimerSnapshotLoad( const void * pvBuffer,
+                                     size_t xBufferSize,
+                                     uint64_t ullNow,
+                                     TimerSnapshotCreateFunction_t pxCreate,
+                                     void * pvContext );
+#endif
 
 void dk_soft_timer_init(getSysTickCount_t fun);
 void dk_timer_task(void);
 
+/*
+ * Ticks until dk_timer_task() next has work to do: 0 if a timer is due, a
+ * command is queued or the tick count has wrapped, portMAX_DELAY if no timer
+ * is running.  Lets the caller sleep, or enter a low power state, instead of
+ * polling dk_timer_task().  Call it from the context of dk_timer_task().
+ */
+TickType_t xTimerGetExpectedIdleTime( void );
+
 #define xTimerReset     xTimerStart
 
+#ifdef __cplusplus
+    }
+#endif
+
 #endif /* USER_DRIVER_INC_DK_SOFT_TIMER_H_ */
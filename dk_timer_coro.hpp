@@ -0,0 +1,235 @@
+/*
+ * dk_timer_coro.hpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  C++20 coroutine awaitables on top of the soft timer.
+ *
+ *      co_await dk::sleep_for( 100 );
+ *      bool ok = co_await dk::with_timeout( xEvent.wait(), 500 );
+ *
+ *  Every awaiter embeds a StaticTimer_t, so the timer lives in the coroutine
+ *  frame and a suspend/resume round trip never calls pvPortMalloc().  The
+ *  coroutine is resumed from inside dk_timer_task(), in the same context as
+ *  ordinary timer callbacks, so everything here must be used from that
+ *  context only.
+ */
+
+#ifndef UITLS_DK_TIMER_CORO_HPP_
+#define UITLS_DK_TIMER_CORO_HPP_
+
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "dk_soft_timer.h"
+
+namespace dk {
+
+/*
+ * Awaiter returned by sleep_for().  The timer is armed in await_suspend() and
+ * its expiry resumes the waiting coroutine.
+ */
+class sleep_awaiter
+{
+public:
+    explicit sleep_awaiter( TickType_t xTicks ) noexcept : xTicks_( xTicks ) {}
+
+    sleep_awaiter( const sleep_awaiter & ) = delete;
+    sleep_awaiter & operator=( const sleep_awaiter & ) = delete;
+
+    ~sleep_awaiter()
+    {
+        /* Also reached from inside prvOnExpired(), once the resumed
+         * coroutine is done with the awaiter.  Deleting the timer there
+         * tells dk_timer_task() not to touch it after the callback returns,
+         * as the frame holding it may be gone by then.  The timer is static
+         * so deleting it is just an O(1) unlink. */
+        if( xTimer_ != nullptr ) {
+            ( void ) xTimerDelete( xTimer_, 0 );
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        /* 0 is not a valid timer period, a zero sleep does not suspend. */
+        return xTicks_ == 0;
+    }
+
+    void await_suspend( std::coroutine_handle<> xHandle ) noexcept
+    {
+        xHandle_ = xHandle;
+        xTimer_ = xTimerCreateStatic( "dk::sleep_for", xTicks_, pdFALSE, this, &prvOnExpired, &xTimerBuffer_ );
+        ( void ) xTimerStart( xTimer_, 0 );
+    }
+
+    void await_resume() noexcept {}
+
+private:
+    static void prvOnExpired( TimerHandle_t xTimer ) noexcept
+    {
+        sleep_awaiter * pxSelf = static_cast< sleep_awaiter * >( pvTimerGetTimerID( xTimer ) );
+
+        pxSelf->xHandle_.resume();
+    }
+
+    TickType_t xTicks_;
+    TimerHandle_t xTimer_ = nullptr;
+    std::coroutine_handle<> xHandle_;
+    StaticTimer_t xTimerBuffer_;
+};
+
+inline sleep_awaiter sleep_for( TickType_t xTicks ) noexcept
+{
+    return sleep_awaiter( xTicks );
+}
+
+/*
+ * One-shot event with a single waiter.  set() resumes the waiting coroutine
+ * directly.  Its awaiter supports await_cancel() so it can be raced against a
+ * timer by with_timeout().
+ */
+class event
+{
+public:
+    class awaiter
+    {
+    public:
+        explicit awaiter( event & xEvent ) noexcept : xEvent_( xEvent ) {}
+
+        bool await_ready() const noexcept { return xEvent_.xIsSet_; }
+        void await_suspend( std::coroutine_handle<> xHandle ) noexcept { xEvent_.xWaiter_ = xHandle; }
+        void await_resume() noexcept {}
+
+        /* Detach the waiter.  Returns true if the coroutine was still
+         * waiting, in which case set() will no longer resume it. */
+        bool await_cancel() noexcept
+        {
+            return static_cast< bool >( std::exchange( xEvent_.xWaiter_, nullptr ) );
+        }
+
+    private:
+        event & xEvent_;
+    };
+
+    awaiter wait() noexcept { return awaiter( *this ); }
+    awaiter operator co_await() noexcept { return awaiter( *this ); }
+
+    bool is_set() const noexcept { return xIsSet_; }
+    void reset() noexcept { xIsSet_ = false; }
+
+    void set() noexcept
+    {
+        xIsSet_ = true;
+
+        if( std::coroutine_handle<> xWaiter = std::exchange( xWaiter_, nullptr ) ) {
+            xWaiter.resume();
+        }
+    }
+
+private:
+    bool xIsSet_ = false;
+    std::coroutine_handle<> xWaiter_;
+};
+
+/*
+ * Awaiter returned by with_timeout().  The wrapped operation must provide
+ * await_ready(), a void await_suspend(), await_resume() and await_cancel().
+ * Whichever of the operation and the timer finishes first resumes the
+ * coroutine.  If the operation wins the timer is stopped, which is an O(1)
+ * unlink; if the timer wins the operation is cancelled.
+ *
+ * co_await yields true/false for operations returning void, otherwise a
+ * std::optional holding the operation's result.
+ */
+template< typename Op >
+class timeout_awaiter
+{
+    using result_t = decltype( std::declval< Op & >().await_resume() );
+
+public:
+    using value_type = std::conditional_t< std::is_void_v< result_t >, bool, std::optional< result_t > >;
+
+    timeout_awaiter( Op && xOp, TickType_t xTicks ) noexcept : xOp_( std::move( xOp ) ), xTicks_( xTicks ) {}
+
+    timeout_awaiter( const timeout_awaiter & ) = delete;
+    timeout_awaiter & operator=( const timeout_awaiter & ) = delete;
+
+    ~timeout_awaiter()
+    {
+        if( xTimer_ != nullptr ) {
+            ( void ) xTimerDelete( xTimer_, 0 );
+        }
+    }
+
+    bool await_ready() noexcept
+    {
+        return xOp_.await_ready();
+    }
+
+    bool await_suspend( std::coroutine_handle<> xHandle ) noexcept
+    {
+        if( xTicks_ == 0 ) {
+            /* The operation is not ready and there is no time to wait. */
+            xTimedOut_ = true;
+            return false;
+        }
+
+        /* Arm the timer first, the operation may complete (and resume the
+         * coroutine) from inside its own await_suspend(). */
+        xHandle_ = xHandle;
+        xTimer_ = xTimerCreateStatic( "dk::with_timeout", xTicks_, pdFALSE, this, &prvOnExpired, &xTimerBuffer_ );
+        ( void ) xTimerStart( xTimer_, 0 );
+        xOp_.await_suspend( xHandle );
+        return true;
+    }
+
+    value_type await_resume()
+    {
+        if( xTimer_ != nullptr ) {
+            ( void ) xTimerStop( xTimer_, 0 );
+        }
+
+        if( xTimedOut_ ) {
+            return value_type {};
+        }
+
+        if constexpr( std::is_void_v< result_t > ) {
+            xOp_.await_resume();
+            return true;
+        }
+        else {
+            return value_type( xOp_.await_resume() );
+        }
+    }
+
+private:
+    static void prvOnExpired( TimerHandle_t xTimer ) noexcept
+    {
+        timeout_awaiter * pxSelf = static_cast< timeout_awaiter * >( pvTimerGetTimerID( xTimer ) );
+
+        if( pxSelf->xOp_.await_cancel() ) {
+            pxSelf->xTimedOut_ = true;
+            pxSelf->xHandle_.resume();
+        }
+    }
+
+    Op xOp_;
+    TickType_t xTicks_;
+    bool xTimedOut_ = false;
+    TimerHandle_t xTimer_ = nullptr;
+    std::coroutine_handle<> xHandle_;
+    StaticTimer_t xTimerBuffer_;
+};
+
+template< typename Op >
+timeout_awaiter< std::decay_t< Op > > with_timeout( Op && xOp, TickType_t xTicks ) noexcept
+{
+    return timeout_awaiter< std::decay_t< Op > >( std::decay_t< Op >( std::forward< Op >( xOp ) ), xTicks );
+}
+
+} /* namespace dk */
+
+#endif /* UITLS_DK_TIMER_CORO_HPP_ */
@@ -0,0 +1,51 @@
+/*
+ * dk_timer_trace.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Binary layout of the timer event trace.  Shared by dk_soft_timer.c, which
+ *  writes the records, and tools/dk_trace_decode.c, which turns a dump back
+ *  into text, so it must not depend on any configuration option.
+ */
+
+#ifndef UITLS_DK_TIMER_TRACE_H_
+#define UITLS_DK_TIMER_TRACE_H_
+
+#include "stdint.h"
+
+#define tmrTRACE_MAGIC                   ( ( uint32_t ) 0x52544b44UL ) /* "DKTR" */
+#define tmrTRACE_VERSION                 ( ( uint16_t ) 1U )
+
+/* Values of the usEvent member.  ulValue holds the item noted alongside. */
+#define tmrTRACE_EVENT_START             ( ( uint16_t ) 1U ) /* Expiry time. */
+#define tmrTRACE_EVENT_STOP              ( ( uint16_t ) 2U ) /* Unused. */
+#define tmrTRACE_EVENT_CHANGE_PERIOD     ( ( uint16_t ) 3U ) /* New period. */
+#define tmrTRACE_EVENT_EXPIRED           ( ( uint16_t ) 4U ) /* Expiry time that was reached. */
+#define tmrTRACE_EVENT_CALLBACK          ( ( uint16_t ) 5U ) /* Callback duration in counter units. */
+
+/*
+ * One trace record.  ulTimestamp is the port run time counter when the event
+ * was written; ulTimer is the timer's TimerRef_t when the timer pool is in
+ * use, otherwise the low 32 bits of its handle.
+ */
+typedef struct xTIMER_TRACE_RECORD
+{
+    uint32_t ulTimestamp;
+    uint32_t ulTimer;
+    uint32_t ulValue;
+    uint16_t usEvent;
+    uint16_t usSequence; /*<< Low bits of the write index, exposes gaps left by overwritten records. */
+} TimerTraceRecord_t;
+
+/* A dump is one header followed by ulCount records, oldest first. */
+typedef struct xTIMER_TRACE_HEADER
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint16_t usRecordSize;
+    uint32_t ulCount;
+    uint32_t ulOverwritten; /*<< Records lost because the ring wrapped before the dump. */
+} TimerTraceHeader_t;
+
+#endif /* UITLS_DK_TIMER_TRACE_H_ */
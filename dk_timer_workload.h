@@ -0,0 +1,57 @@
+/*
+ * dk_timer_workload.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Binary layout of a recorded timer workload.  Shared by dk_soft_timer.c,
+ *  which records the calls made by the application, and tools/dk_replay.c,
+ *  which replays them on a virtual clock, so it must not depend on any
+ *  configuration option.
+ */
+
+#ifndef UITLS_DK_TIMER_WORKLOAD_H_
+#define UITLS_DK_TIMER_WORKLOAD_H_
+
+#include "stdint.h"
+
+#define tmrWORKLOAD_MAGIC                  ( ( uint32_t ) 0x4c574b44UL ) /* "DKWL" */
+#define tmrWORKLOAD_VERSION                ( ( uint16_t ) 1U )
+
+/* Values of the ucOp member.  ulValue holds the item noted alongside. */
+#define tmrWORKLOAD_OP_CREATE              ( ( uint8_t ) 1U ) /* Period, ucFlags holds tmrWORKLOAD_FLAG_AUTORELOAD. */
+#define tmrWORKLOAD_OP_START               ( ( uint8_t ) 2U ) /* Command time. */
+#define tmrWORKLOAD_OP_STOP                ( ( uint8_t ) 3U ) /* Unused. */
+#define tmrWORKLOAD_OP_CHANGE_PERIOD       ( ( uint8_t ) 4U ) /* New period. */
+#define tmrWORKLOAD_OP_DELETE              ( ( uint8_t ) 5U ) /* Unused. */
+#define tmrWORKLOAD_OP_TASK                ( ( uint8_t ) 6U ) /* Unused, a dk_timer_task() pass that found a timer due or the tick count overflowed. */
+#define tmrWORKLOAD_OP_EXPIRED             ( ( uint8_t ) 7U ) /* Expiry time that was reached. */
+
+#define tmrWORKLOAD_FLAG_AUTORELOAD        ( ( uint8_t ) 0x01U )
+
+/*
+ * One recorded call.  ulTick is the tick count when it was made.  ulTimer is
+ * a number the timer was given when it was created, counting from 1, so it
+ * stays unique after the timer is deleted and its memory reused.  It only
+ * wraps after 2^32 timers have been created.
+ */
+typedef struct xTIMER_WORKLOAD_RECORD
+{
+    uint32_t ulTick;
+    uint32_t ulTimer;
+    uint32_t ulValue;
+    uint8_t ucOp;
+    uint8_t ucFlags;
+    uint16_t usReserved;
+} TimerWorkloadRecord_t;
+
+/* A recording is one header followed by records up to the end of the file,
+ * in the order the calls were made. */
+typedef struct xTIMER_WORKLOAD_HEADER
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint16_t usRecordSize;
+} TimerWorkloadHeader_t;
+
+#endif /* UITLS_DK_TIMER_WORKLOAD_H_ */
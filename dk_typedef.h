@@ -31,6 +31,19 @@ typedef portUBASE_TYPE TickType_t;
 #define portLONG        long
 #define portSHORT       short
 
+/* Route allocations through the NUMA-aware, huge page backed arenas of
+ * dk_port_posix.c.  The static timer pools are placed with the same policy,
+ * see portTIMER_POOL_PLACE(). */
+#if defined( configUSE_PORT_ARENA ) && ( configUSE_PORT_ARENA == 1 )
+    void * pvPortArenaMalloc( size_t xSize );
+    void vPortArenaFree( void * pv );
+    void vPortArenaPlace( void * pv, size_t xSize );
+
+    #define pvPortMalloc                         pvPortArenaMalloc
+    #define vPortFree                            vPortArenaFree
+    #define portTIMER_POOL_PLACE( pv, xSize )    vPortArenaPlace( ( pv ), ( xSize ) )
+#endif
+
 #ifndef pvPortMalloc
 #define pvPortMalloc        malloc
 #endif
@@ -46,6 +59,131 @@ typedef portUBASE_TYPE TickType_t;
 #define pdTRUE                                   ( ( BaseType_t ) 1 )
 #endif
 
+/* Free running counter used to time timer callbacks and to stamp trace
+ * records.  Only x86 hosts get one by default, other ports must map it to a
+ * cycle counter (DWT->CYCCNT on Cortex-M) to use configUSE_TIMER_TRACE or
+ * configUSE_TIMER_CALLBACK_BUDGET. */
+#ifndef portGET_RUN_TIME_COUNTER_VALUE
+    #if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+        #define portGET_RUN_TIME_COUNTER_VALUE()    ( ( uint32_t ) __builtin_ia32_rdtsc() )
+    #endif
+#endif
+
+/* Atomically add ul to *pul and return the previous value. */
+#ifndef portATOMIC_FETCH_ADD_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_FETCH_ADD_U32( pul, ul )    __atomic_fetch_add( ( pul ), ( ul ), __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_FETCH_ADD_U32( pul, ul )    ( ( *( pul ) += ( ul ) ) - ( ul ) )
+    #endif
+#endif
+
+/* Atomic accessors used by the lock-free timer command queue.  The fallbacks
+ * are plain accesses, which are only safe if the port makes them atomic with
+ * respect to every context that sends commands. */
+#ifndef portATOMIC_LOAD_ACQUIRE_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_LOAD_ACQUIRE_U32( pul )    __atomic_load_n( ( pul ), __ATOMIC_ACQUIRE )
+    #else
+        #define portATOMIC_LOAD_ACQUIRE_U32( pul )    ( *( volatile uint32_t * ) ( pul ) )
+    #endif
+#endif
+
+#ifndef portATOMIC_STORE_RELEASE_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_STORE_RELEASE_U32( pul, ul )    __atomic_store_n( ( pul ), ( ul ), __ATOMIC_RELEASE )
+    #else
+        #define portATOMIC_STORE_RELEASE_U32( pul, ul )    ( *( volatile uint32_t * ) ( pul ) = ( ul ) )
+    #endif
+#endif
+
+/* Relaxed accessors for the timer state that other threads may read, see
+ * configUSE_TIMER_CONCURRENT_READS.  Only atomicity is needed, the ordering
+ * comes from the sequence counters.  The fallbacks are volatile accesses,
+ * which a port may only use if aligned bytes and words are accessed whole. */
+#ifndef portATOMIC_LOAD_RELAXED_U8
+    #if defined( __GNUC__ )
+        #define portATOMIC_LOAD_RELAXED_U8( puc )    __atomic_load_n( ( puc ), __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_LOAD_RELAXED_U8( puc )    ( *( volatile const uint8_t * ) ( puc ) )
+    #endif
+#endif
+
+#ifndef portATOMIC_STORE_RELAXED_U8
+    #if defined( __GNUC__ )
+        #define portATOMIC_STORE_RELAXED_U8( puc, uc )    __atomic_store_n( ( puc ), ( uc ), __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_STORE_RELAXED_U8( puc, uc )    ( *( volatile uint8_t * ) ( puc ) = ( uc ) )
+    #endif
+#endif
+
+#ifndef portATOMIC_LOAD_RELAXED_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_LOAD_RELAXED_U32( pul )    __atomic_load_n( ( pul ), __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_LOAD_RELAXED_U32( pul )    ( *( volatile const uint32_t * ) ( pul ) )
+    #endif
+#endif
+
+#ifndef portATOMIC_STORE_RELAXED_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_STORE_RELAXED_U32( pul, ul )    __atomic_store_n( ( pul ), ( ul ), __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_STORE_RELAXED_U32( pul, ul )    ( *( volatile uint32_t * ) ( pul ) = ( ul ) )
+    #endif
+#endif
+
+/* If *pul equals *pulExpected store ulDesired and return non-zero, otherwise
+ * load the current value into *pulExpected and return zero. */
+#ifndef portATOMIC_COMPARE_EXCHANGE_U32
+    #if defined( __GNUC__ )
+        #define portATOMIC_COMPARE_EXCHANGE_U32( pul, pulExpected, ulDesired ) \
+    __atomic_compare_exchange_n( ( pul ), ( pulExpected ), ( ulDesired ), 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED )
+    #else
+        #define portATOMIC_COMPARE_EXCHANGE_U32( pul, pulExpected, ulDesired ) \
+    ( ( *( pul ) == *( pulExpected ) ) ? ( *( pul ) = ( ulDesired ), 1 ) : ( *( pulExpected ) = *( pul ), 0 ) )
+    #endif
+#endif
+
+/* Memory fences for the sequence counters that let other threads read timer
+ * state, see configUSE_TIMER_CONCURRENT_READS.  A port with a single core may
+ * define them as compiler barriers. */
+#ifndef portATOMIC_THREAD_FENCE_ACQUIRE
+    #if defined( __GNUC__ )
+        #define portATOMIC_THREAD_FENCE_ACQUIRE()    __atomic_thread_fence( __ATOMIC_ACQUIRE )
+    #else
+        #define portATOMIC_THREAD_FENCE_ACQUIRE()
+    #endif
+#endif
+
+#ifndef portATOMIC_THREAD_FENCE_RELEASE
+    #if defined( __GNUC__ )
+        #define portATOMIC_THREAD_FENCE_RELEASE()    __atomic_thread_fence( __ATOMIC_RELEASE )
+    #else
+        #define portATOMIC_THREAD_FENCE_RELEASE()
+    #endif
+#endif
+
+/* Called after a command has been posted to the FromISR command queue with
+ * the tick at which it takes effect, so a sleeping timer service can be woken
+ * early.  Stop commands do not call it.  See dk_timer_run() in
+ * dk_port_posix.h. */
+#if defined( configUSE_PORT_RUN_LOOP ) && ( configUSE_PORT_RUN_LOOP == 1 )
+    void vPortTimerRunNotify( TickType_t xDueTime );
+
+    #define portTIMER_SERVICE_NOTIFY( xDueTime )    vPortTimerRunNotify( xDueTime )
+#endif
+
+#ifndef portTIMER_SERVICE_NOTIFY
+    #define portTIMER_SERVICE_NOTIFY( xDueTime )
+#endif
+
+/* Called by dk_soft_timer_init() for each large static pool before it is
+ * first written, so a port can set the memory policy of its pages. */
+#ifndef portTIMER_POOL_PLACE
+    #define portTIMER_POOL_PLACE( pv, xSize )
+#endif
+
 #ifndef configASSERT
 #define configASSERT( x )
 #endif
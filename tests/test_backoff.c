@@ -0,0 +1,101 @@
+/*
+ * test_backoff.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  The delays of a backoff timer grow from the delay before jitter, so with
+ *  50% jitter every delay stays within half of the nominal one however many
+ *  retries came before, and stopping the timer starts over at the base.
+ *  A retry sequence started through the command queue keeps going even if
+ *  the start is applied after the first delay has already passed.
+ */
+
+#include "test_util.h"
+
+#define TEST_TIMERS     16
+#define TEST_RETRIES    8
+
+static const TimerBackoffPolicy_t xPolicy = { 100U, 1000U, 0x0200U, 50U };
+static const TickType_t xNominal[ TEST_RETRIES ] = { 100U, 200U, 400U, 800U, 1000U, 1000U, 1000U, 1000U };
+
+static uint32_t ulLastCall[ TEST_TIMERS ];
+static uint32_t ulCalls[ TEST_TIMERS ];
+static uint32_t ulLateCalls;
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    const uintptr_t x = ( uintptr_t ) pvTimerGetTimerID( xTimer );
+    const uint32_t ulDelay = ulTestTick - ulLastCall[ x ];
+    const TickType_t xExpected = xNominal[ ulCalls[ x ] ];
+
+    TEST_CHECK( ulDelay <= xExpected );
+    TEST_CHECK( ulDelay >= ( xExpected - ( xExpected / 2U ) ) );
+
+    ulLastCall[ x ] = ulTestTick;
+
+    if( ++ulCalls[ x ] == TEST_RETRIES ) {
+        xTimerStop( xTimer, 0 );
+    }
+}
+
+static void prvLateCallback( TimerHandle_t xTimer )
+{
+    if( ++ulLateCalls == TEST_RETRIES ) {
+        xTimerStop( xTimer, 0 );
+    }
+}
+
+int main( void )
+{
+    static StaticTimer_t xBuffer;
+    TimerHandle_t xTimers[ TEST_TIMERS ];
+    TickType_t xFirst;
+    uint32_t ulTick;
+    TimerHandle_t xLate;
+    uintptr_t x;
+
+    dk_soft_timer_init( &prvTestGetTick );
+    vTimerSetBackoffSeed( 12345U );
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        xTimers[ x ] = ( x == 0U ) ? xTimerCreateBackoffStatic( "retry", &xPolicy, ( void * ) x, prvCallback, &xBuffer ) :
+                       xTimerCreateBackoff( "retry", &xPolicy, ( void * ) x, prvCallback );
+        TEST_CHECK( xTimers[ x ] != NULL );
+        xTimerStart( xTimers[ x ], 0 );
+    }
+
+    for( ulTick = 1U; ulTick <= 6000U; ulTick++ ) {
+        vTestRunAt( ulTick );
+    }
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        TEST_CHECK( ulCalls[ x ] == TEST_RETRIES );
+        TEST_CHECK( xTimerIsTimerActive( xTimers[ x ] ) == pdFALSE );
+
+        /* Stopped, so the next start is back at the base delay. */
+        xFirst = xTimerGetPeriod( xTimers[ x ] );
+        TEST_CHECK( ( xFirst <= 100U ) && ( xFirst >= 50U ) );
+    }
+
+    /* Posted at 10000 but only applied at 10300, past the first delay, so
+     * the first retry runs at once and the next ones follow from there. */
+    xLate = xTimerCreateBackoff( "late", &xPolicy, NULL, prvLateCallback );
+    TEST_CHECK( xLate != NULL );
+    ulTestTick = 10000U;
+    TEST_CHECK( xTimerStartFromISR( xLate, NULL ) == pdTRUE );
+
+    vTestRunAt( 10300U );
+    TEST_CHECK( ulLateCalls == 1U );
+    TEST_CHECK( xTimerIsTimerActive( xLate ) == pdTRUE );
+
+    for( ulTick = 10301U; ulTick <= 16000U; ulTick++ ) {
+        vTestRunAt( ulTick );
+    }
+
+    TEST_CHECK( ulLateCalls == TEST_RETRIES );
+    TEST_CHECK( xTimerIsTimerActive( xLate ) == pdFALSE );
+
+    printf( "test_backoff: ok\n" );
+    return 0;
+}
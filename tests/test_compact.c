@@ -0,0 +1,93 @@
+/*
+ * test_compact.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  A burst of due compact timers is drained configTIMER_COMPACT_MAX_EXPIRIES
+ *  per dk_timer_task() pass, in expiry order, and auto-reload timers that
+ *  fell behind catch up within a pass.
+ */
+
+#include "test_util.h"
+
+#define TEST_TIMERS    1000U
+
+static TimerRef_t xRefs[ TEST_TIMERS ];
+static uint32_t ulFired[ TEST_TIMERS ];
+static uint32_t ulCalls;
+static uint32_t ulLastBucket;
+static uint32_t ulReloads;
+
+static void prvOneShot( TimerRef_t xRef )
+{
+    const uint32_t x = ( uint32_t ) ( xRef & ( ( ( TimerRef_t ) 1U << configTIMER_REF_INDEX_BITS ) - 1U ) );
+
+    /* Timer x has a period of 10 + x / 100. */
+    TEST_CHECK( ( x / 100U ) >= ulLastBucket );
+    ulLastBucket = x / 100U;
+    ulFired[ x ]++;
+    ulCalls++;
+
+    if( ( x & 1U ) != 0U ) {
+        TEST_CHECK( xTimerCompactDelete( xRef ) == pdTRUE );
+    }
+}
+
+static void prvReload( TimerRef_t xRef )
+{
+    ( void ) xRef;
+    ulReloads++;
+}
+
+int main( void )
+{
+    UBaseType_t uxOneShot;
+    UBaseType_t uxReload;
+    TimerRef_t xReload;
+    uint32_t ulPasses;
+    uint32_t x;
+
+    dk_soft_timer_init( &prvTestGetTick );
+    uxOneShot = uxTimerCompactRegisterCallback( prvOneShot );
+    uxReload = uxTimerCompactRegisterCallback( prvReload );
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        xRefs[ x ] = xTimerCompactCreate( 10U + ( x / 100U ), pdFALSE, uxOneShot );
+        TEST_CHECK( xRefs[ x ] != tmrINVALID_TIMER_REF );
+        TEST_CHECK( xTimerCompactStart( xRefs[ x ] ) == pdTRUE );
+    }
+
+    /* Everything is due at once: each pass takes the next
+     * configTIMER_COMPACT_MAX_EXPIRIES in order, none is left behind. */
+    ulTestTick = 100U;
+
+    for( ulPasses = 0U; ulCalls < TEST_TIMERS; ulPasses++ ) {
+        dk_timer_task();
+        TEST_CHECK( ulCalls == ( ( ( ulPasses + 1U ) * configTIMER_COMPACT_MAX_EXPIRIES < TEST_TIMERS ) ?
+                                 ( ulPasses + 1U ) * configTIMER_COMPACT_MAX_EXPIRIES : TEST_TIMERS ) );
+    }
+
+    TEST_CHECK( ulPasses == ( ( TEST_TIMERS + configTIMER_COMPACT_MAX_EXPIRIES - 1U ) / configTIMER_COMPACT_MAX_EXPIRIES ) );
+    TEST_CHECK( xTimerGetExpectedIdleTime() == portMAX_DELAY );
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        TEST_CHECK( ulFired[ x ] == 1U );
+        TEST_CHECK( xTimerCompactIsTimerActive( xRefs[ x ] ) == pdFALSE );
+        TEST_CHECK( xTimerCompactDelete( xRefs[ x ] ) == ( ( ( x & 1U ) == 0U ) ? pdTRUE : pdFALSE ) );
+    }
+
+    /* 30 periods behind, caught up in one pass. */
+    xReload = xTimerCompactCreate( 5U, pdTRUE, uxReload );
+    TEST_CHECK( xTimerCompactStart( xReload ) == pdTRUE );
+    ulTestTick += 150U;
+    dk_timer_task();
+    TEST_CHECK( ulReloads == 30U );
+    TEST_CHECK( xTimerGetExpectedIdleTime() == 5U );
+
+    vTestRunAt( ulTestTick + 5U );
+    TEST_CHECK( ulReloads == 31U );
+
+    printf( "test_compact: ok\n" );
+    return 0;
+}
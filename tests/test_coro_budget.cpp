@@ -0,0 +1,78 @@
+/*
+ * test_coro_budget.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  With callback budgets enabled dk_timer_task() goes back to the timer once
+ *  the callback returns.  A coroutine resumed by sleep_for() that runs to
+ *  completion frees the frame holding that timer before then.
+ */
+
+#include "dk_timer_coro.hpp"
+
+#include "test_util.h"
+
+extern "C" void vApplicationTimerOverrunHook( TimerHandle_t xTimer,
+                                              const char * pcTimerName,
+                                              uint32_t ulDuration )
+{
+    ( void ) xTimer;
+    ( void ) pcTimerName;
+    ( void ) ulDuration;
+}
+
+/* Runs eagerly and frees its frame as soon as the body returns. */
+struct detached
+{
+    struct promise_type
+    {
+        detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+};
+
+static uint32_t ulWakeTicks[ 4 ];
+static uint32_t ulWakeCount;
+static dk::event xEvent;
+
+static detached prvSleeper()
+{
+    co_await dk::sleep_for( 10 );
+    ulWakeTicks[ ulWakeCount++ ] = ulTestTick;
+    co_await dk::sleep_for( 5 );
+    ulWakeTicks[ ulWakeCount++ ] = ulTestTick;
+}
+
+static detached prvWaiter()
+{
+    const bool xSet = co_await dk::with_timeout( xEvent.wait(), 20 );
+
+    TEST_CHECK( !xSet );
+    ulWakeTicks[ ulWakeCount++ ] = ulTestTick;
+}
+
+int main( void )
+{
+    uint32_t ulTick;
+
+    dk_soft_timer_init( &prvTestGetTick );
+
+    prvSleeper();
+    prvWaiter();
+
+    for( ulTick = 1; ulTick <= 30; ulTick++ ) {
+        vTestRunAt( ulTick );
+    }
+
+    TEST_CHECK( ulWakeCount == 3U );
+    TEST_CHECK( ulWakeTicks[ 0 ] == 10U );
+    TEST_CHECK( ulWakeTicks[ 1 ] == 15U );
+    TEST_CHECK( ulWakeTicks[ 2 ] == 20U );
+
+    printf( "test_coro_budget: ok\n" );
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * test_iterator.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  The iterator returns the same timers in expiry order whether the lists
+ *  or the heaps are in use, including once its frontier has overflowed,
+ *  and returns timers held back by a class budget first, as due.
+ */
+
+#include <string.h>
+
+#include "test_util.h"
+
+#define TEST_TIMERS    200
+
+static TimerHandle_t xTimers[ TEST_TIMERS ];
+static uint32_t ulCalls;
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+    ulCalls++;
+}
+
+/* Walks the timers within xWithin, checks the order and returns how many
+ * there were, with a bitmap of which in pucSeen. */
+static uint32_t prvWalk( TickType_t xWithin,
+                         uint8_t * pucSeen )
+{
+    TimerIterator_t xIterator;
+    TimerHandle_t xTimer;
+    TickType_t xRemaining;
+    TickType_t xLast = 0U;
+    uint32_t ulCount = 0U;
+
+    memset( pucSeen, 0, TEST_TIMERS );
+    vTimerIteratorInit( &xIterator, xWithin );
+
+    while( xTimerIteratorNext( &xIterator, &xTimer, &xRemaining ) != pdFALSE ) {
+        const uintptr_t x = ( uintptr_t ) pvTimerGetTimerID( xTimer );
+
+        TEST_CHECK( x < TEST_TIMERS );
+        TEST_CHECK( pucSeen[ x ] == 0U );
+        TEST_CHECK( xRemaining >= xLast );
+        TEST_CHECK( xRemaining <= xWithin );
+        pucSeen[ x ] = 1U;
+        xLast = xRemaining;
+        ulCount++;
+    }
+
+    return ulCount;
+}
+
+int main( void )
+{
+    static const TickType_t xWindows[] = { 0U, 5U, 50U, 300U, 1000U, portMAX_DELAY };
+    uint8_t ucSeenList[ TEST_TIMERS ];
+    uint8_t ucSeenHeap[ TEST_TIMERS ];
+    uint32_t ulRandom = 1U;
+    uint32_t ulCount;
+    TimerIterator_t xIterator;
+    TimerHandle_t xTimer;
+    TickType_t xRemaining;
+    uintptr_t x;
+    size_t w;
+
+    /* Close enough to the wrap for part of the timers to go into the
+     * overflow list. */
+    ulTestTick = 0xfffffe00UL;
+    dk_soft_timer_init( &prvTestGetTick );
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+        xTimers[ x ] = xTimerCreate( "t", 1U + ( ( ulRandom >> 16 ) % 1000U ), pdFALSE, ( void * ) x, prvCallback );
+        TEST_CHECK( xTimers[ x ] != NULL );
+        xTimerStart( xTimers[ x ], 0 );
+    }
+
+    for( w = 0; w < ( sizeof( xWindows ) / sizeof( xWindows[ 0 ] ) ); w++ ) {
+        TEST_CHECK( xTimerSetBackend( tmrBACKEND_LIST ) != pdFALSE );
+        ulCount = prvWalk( xWindows[ w ], ucSeenList );
+        TEST_CHECK( xTimerSetBackend( tmrBACKEND_HEAP ) != pdFALSE );
+        TEST_CHECK( uxTimerGetActiveBackend() == tmrBACKEND_HEAP );
+        TEST_CHECK( prvWalk( xWindows[ w ], ucSeenHeap ) == ulCount );
+        TEST_CHECK( memcmp( ucSeenList, ucSeenHeap, TEST_TIMERS ) == 0 );
+    }
+
+    TEST_CHECK( ulCount == TEST_TIMERS );
+
+    /* Three timers due on the same tick, a budget of one callback a pass. */
+    dk_soft_timer_init( &prvTestGetTick );
+    vTimerSetClassBudget( 0, 1 );
+
+    for( x = 0; x < 3U; x++ ) {
+        xTimers[ x ] = xTimerCreate( "due", 10U, pdFALSE, ( void * ) x, prvCallback );
+        xTimerStart( xTimers[ x ], 0 );
+    }
+
+    xTimers[ 3 ] = xTimerCreate( "later", 100U, pdFALSE, ( void * ) 3, prvCallback );
+    xTimerStart( xTimers[ 3 ], 0 );
+
+    ulTestTick += 10U;
+    ulCalls = 0U;
+    dk_timer_task();
+    TEST_CHECK( ulCalls == 1U );
+
+    vTimerIteratorInit( &xIterator, portMAX_DELAY );
+    ulCount = 0U;
+
+    while( xTimerIteratorNext( &xIterator, &xTimer, &xRemaining ) != pdFALSE ) {
+        TEST_CHECK( ( ( uintptr_t ) pvTimerGetTimerID( xTimer ) < 3U ) == ( ulCount < 2U ) );
+        TEST_CHECK( ( xRemaining == 0U ) == ( ulCount < 2U ) );
+        ulCount++;
+    }
+
+    TEST_CHECK( ulCount == 3U );
+
+    printf( "test_iterator: ok\n" );
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * test_lazy_classes.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  A lazy reset of a timer that is already queued for its callback in a
+ *  lower priority class must move it, not just record the new deadline.
+ */
+
+#include "test_util.h"
+
+static TimerHandle_t xLazy;
+static TimerHandle_t xUrgent;
+static uint32_t ulLazyCalls;
+static uint32_t ulLazyCallTick;
+
+static void prvLazyCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+    ulLazyCalls++;
+    ulLazyCallTick = ulTestTick;
+}
+
+static void prvUrgentCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+
+    /* Runs first, while xLazy is queued in class 0. */
+    xTimerReset( xLazy, 0 );
+}
+
+int main( void )
+{
+    dk_soft_timer_init( &prvTestGetTick );
+
+    xLazy = xTimerCreate( "lazy", 100, pdFALSE, NULL, prvLazyCallback );
+    xUrgent = xTimerCreate( "urgent", 100, pdFALSE, NULL, prvUrgentCallback );
+    TEST_CHECK( ( xLazy != NULL ) && ( xUrgent != NULL ) );
+
+    vTimerSetLazyReset( xLazy, pdTRUE );
+    vTimerSetPriorityClass( xUrgent, 1 );
+
+    xTimerStart( xLazy, 0 );
+    xTimerStart( xUrgent, 0 );
+
+    vTestRunAt( 100 );
+    TEST_CHECK( ulLazyCalls == 0U );
+    TEST_CHECK( xTimerIsTimerActive( xLazy ) != pdFALSE );
+    TEST_CHECK( xTimerGetExpiryTime( xLazy ) == 200U );
+
+    vTestRunAt( 199 );
+    TEST_CHECK( ulLazyCalls == 0U );
+
+    vTestRunAt( 200 );
+    TEST_CHECK( ulLazyCalls == 1U );
+    TEST_CHECK( ulLazyCallTick == 200U );
+    TEST_CHECK( xTimerIsTimerActive( xLazy ) == pdFALSE );
+
+    /* The reset must not leave a deadline behind for a later pass. */
+    vTestRunAt( 400 );
+    TEST_CHECK( ulLazyCalls == 1U );
+
+    printf( "test_lazy_classes: ok\n" );
+    return 0;
+}
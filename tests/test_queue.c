@@ -0,0 +1,110 @@
+/*
+ * test_queue.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Several threads post pended calls and FromISR timer commands to the
+ *  command queue at once while the main thread runs the timer task.  Every
+ *  call must run exactly once, and the calls and commands of each thread
+ *  must be applied in the order that thread posted them.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "test_util.h"
+
+#define TEST_PRODUCERS    4
+#define TEST_CALLS        20000U
+#define TEST_COMMANDS     500U
+
+static uint32_t ulNextCall[ TEST_PRODUCERS ];
+static uint32_t ulFired[ TEST_PRODUCERS ];
+static TimerHandle_t xTimers[ TEST_PRODUCERS ];
+static volatile int iProducersDone;
+
+static void prvPended( void * pvParameter1, uint32_t ulParameter2 )
+{
+    const uintptr_t x = ( uintptr_t ) pvParameter1;
+
+    TEST_CHECK( ulParameter2 == ulNextCall[ x ] );
+    ulNextCall[ x ]++;
+}
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    ulFired[ ( uintptr_t ) pvTimerGetTimerID( xTimer ) ]++;
+}
+
+static void * prvProducer( void * pvArg )
+{
+    const uintptr_t x = ( uintptr_t ) pvArg;
+    uint32_t ulCall;
+    BaseType_t xPosted;
+
+    for( ulCall = 0U; ulCall < TEST_CALLS; ulCall++ ) {
+        do {
+            xPosted = ( ( ulCall & 1U ) != 0U ) ?
+                      xTimerPendFunctionCallFromISR( prvPended, ( void * ) x, ulCall, NULL ) :
+                      xTimerPendFunctionCall( prvPended, ( void * ) x, ulCall, 0 );
+
+            if( xPosted == pdFALSE ) {
+                sched_yield();
+            }
+        } while( xPosted == pdFALSE );
+
+        if( ( ulCall % ( TEST_CALLS / TEST_COMMANDS ) ) == 0U ) {
+            /* The last period posted must be the one left in the timer. */
+            while( xTimerChangePeriodFromISR( xTimers[ x ], 1U + ( ulCall % 7U ) + x, NULL ) == pdFALSE ) {
+                sched_yield();
+            }
+        }
+    }
+
+    __atomic_add_fetch( &iProducersDone, 1, __ATOMIC_RELEASE );
+    return NULL;
+}
+
+int main( void )
+{
+    pthread_t xThreads[ TEST_PRODUCERS ];
+    uint32_t ulLastPeriod;
+    uintptr_t x;
+
+    dk_soft_timer_init( &prvTestGetTick );
+
+    for( x = 0; x < TEST_PRODUCERS; x++ ) {
+        xTimers[ x ] = xTimerCreate( "queue", 100U, pdFALSE, ( void * ) x, prvCallback );
+        TEST_CHECK( xTimers[ x ] != NULL );
+    }
+
+    for( x = 0; x < TEST_PRODUCERS; x++ ) {
+        TEST_CHECK( pthread_create( &xThreads[ x ], NULL, prvProducer, ( void * ) x ) == 0 );
+    }
+
+    while( __atomic_load_n( &iProducersDone, __ATOMIC_ACQUIRE ) < TEST_PRODUCERS ) {
+        __atomic_add_fetch( &ulTestTick, 1U, __ATOMIC_RELAXED );
+        dk_timer_task();
+    }
+
+    for( x = 0; x < TEST_PRODUCERS; x++ ) {
+        TEST_CHECK( pthread_join( xThreads[ x ], NULL ) == 0 );
+    }
+
+    /* Drain what was posted after the last pass, then let the timers fire. */
+    vTestRunAt( ulTestTick );
+    vTestRunAt( ulTestTick + 100U );
+
+    ulLastPeriod = ( ( TEST_CALLS - ( TEST_CALLS / TEST_COMMANDS ) ) % 7U ) + 1U;
+
+    for( x = 0; x < TEST_PRODUCERS; x++ ) {
+        TEST_CHECK( ulNextCall[ x ] == TEST_CALLS );
+        TEST_CHECK( xTimerGetPeriod( xTimers[ x ] ) == ( ulLastPeriod + x ) );
+        TEST_CHECK( ulFired[ x ] > 0U );
+        TEST_CHECK( xTimerIsTimerActive( xTimers[ x ] ) == pdFALSE );
+    }
+
+    printf( "test_queue: ok\n" );
+    return 0;
+}
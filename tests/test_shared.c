@@ -0,0 +1,242 @@
+/*
+ * test_shared.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  The shared timer service with forked clients.  Expiries reach the owning
+ *  process, the timers and client slot of a client that exits without
+ *  detaching are reclaimed, and a client writing over the whole segment
+ *  cannot corrupt the dispatcher's timer lists.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test_util.h"
+#include "dk_port_posix.h"
+
+static char cName[ 64 ];
+static SharedTimerServiceHandle_t xDispatcher;
+static uint32_t ulLocalFired;
+
+static void prvLocalCallback( TimerHandle_t xTimer )
+{
+    ( void ) xTimer;
+    ulLocalFired++;
+}
+
+/* One pass of the dispatcher loop, one tick per pass. */
+static void prvDispatch( void )
+{
+    ( void ) uxSharedTimerServiceProcess( xDispatcher );
+    ulTestTick++;
+    dk_timer_task();
+    vSharedTimerServiceWait( xDispatcher, 1 );
+}
+
+static void prvWaitChild( pid_t xPid,
+                          BaseType_t xDispatching )
+{
+    int iStatus;
+
+    if( xDispatching != pdFALSE ) {
+        while( waitpid( xPid, &iStatus, WNOHANG ) != xPid ) {
+            prvDispatch();
+        }
+    }
+    else {
+        TEST_CHECK( waitpid( xPid, &iStatus, 0 ) == xPid );
+    }
+
+    TEST_CHECK( WIFEXITED( iStatus ) && ( WEXITSTATUS( iStatus ) == 0 ) );
+}
+
+static void prvChildReceive( void )
+{
+    SharedTimerServiceHandle_t xClient = xSharedTimerClientAttach( cName );
+    SharedTimerExpiry_t xExpiries[ 4 ];
+    UBaseType_t uxReceived = 0U;
+    UBaseType_t uxCount;
+    TimerRef_t xRef;
+
+    TEST_CHECK( xClient != NULL );
+    xRef = xSharedTimerCreate( xClient, 5U, pdTRUE, 0x123456789aULL );
+    TEST_CHECK( xRef != tmrINVALID_TIMER_REF );
+    TEST_CHECK( xSharedTimerStart( xClient, xRef ) == pdTRUE );
+
+    while( uxReceived < 3U ) {
+        uxCount = uxSharedTimerReceive( xClient, xExpiries, 4U, 5000 );
+        TEST_CHECK( uxCount > 0U );
+
+        while( uxCount-- > 0U ) {
+            TEST_CHECK( xExpiries[ uxCount ].xRef == xRef );
+            TEST_CHECK( xExpiries[ uxCount ].ullUserData == 0x123456789aULL );
+            uxReceived++;
+        }
+    }
+
+    vSharedTimerClientDetach( xClient );
+    exit( 0 );
+}
+
+/* Arms every timer of the segment, then dies without detaching. */
+static void prvChildAbandon( int iReady,
+                             int iGo )
+{
+    SharedTimerServiceHandle_t xClient = xSharedTimerClientAttach( cName );
+    TimerRef_t xRef;
+    char c = 0;
+    uint32_t x;
+
+    TEST_CHECK( xClient != NULL );
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        xRef = xSharedTimerCreate( xClient, 10U + x, pdTRUE, x );
+        TEST_CHECK( xRef != tmrINVALID_TIMER_REF );
+        TEST_CHECK( xSharedTimerStart( xClient, xRef ) == pdTRUE );
+    }
+
+    TEST_CHECK( write( iReady, &c, 1 ) == 1 );
+    ( void ) read( iGo, &c, 1 );
+    _exit( 0 );
+}
+
+/* Arms a timer, then writes over the whole segment once it runs. */
+static void prvChildScribble( int iReady,
+                              int iGo )
+{
+    SharedTimerServiceHandle_t xClient = xSharedTimerClientAttach( cName );
+    struct stat xStat;
+    void * pvMap;
+    char c = 0;
+    int iFd;
+
+    TEST_CHECK( xClient != NULL );
+    TEST_CHECK( xSharedTimerStart( xClient, xSharedTimerCreate( xClient, 3U, pdTRUE, 0U ) ) == pdTRUE );
+    TEST_CHECK( write( iReady, &c, 1 ) == 1 );
+    ( void ) read( iGo, &c, 1 );
+
+    iFd = shm_open( cName, O_RDWR, 0 );
+    TEST_CHECK( ( iFd >= 0 ) && ( fstat( iFd, &xStat ) == 0 ) );
+    pvMap = mmap( NULL, ( size_t ) xStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0 );
+    TEST_CHECK( pvMap != MAP_FAILED );
+    ( void ) memset( pvMap, 0xa5, ( size_t ) xStat.st_size );
+    _exit( 0 );
+}
+
+static pid_t prvForkWithPipes( void ( * pxChild )( int, int ),
+                               int * piGo )
+{
+    int iReady[ 2 ];
+    int iGo[ 2 ];
+    pid_t xPid;
+    char c;
+
+    TEST_CHECK( ( pipe( iReady ) == 0 ) && ( pipe( iGo ) == 0 ) );
+    xPid = fork();
+    TEST_CHECK( xPid >= 0 );
+
+    if( xPid == 0 ) {
+        ( void ) close( iReady[ 0 ] );
+        ( void ) close( iGo[ 1 ] );
+        pxChild( iReady[ 1 ], iGo[ 0 ] );
+    }
+
+    ( void ) close( iReady[ 1 ] );
+    ( void ) close( iGo[ 0 ] );
+    TEST_CHECK( read( iReady[ 0 ], &c, 1 ) == 1 );
+    ( void ) close( iReady[ 0 ] );
+    *piGo = iGo[ 1 ];
+
+    /* The child's commands are all posted, apply them. */
+    while( uxSharedTimerServiceProcess( xDispatcher ) != 0U ) {
+    }
+
+    dk_timer_task();
+
+    return xPid;
+}
+
+int main( void )
+{
+    SharedTimerServiceHandle_t xClient;
+    SharedTimerServiceHandle_t xSecond;
+    TimerHandle_t xLocal;
+    uint32_t ulPasses;
+    uint32_t x;
+    pid_t xPid;
+    int iGo;
+
+    ( void ) snprintf( cName, sizeof( cName ), "/dk_test_shared_%d", ( int ) getpid() );
+    dk_soft_timer_init( &prvTestGetTick );
+    xDispatcher = xSharedTimerServiceCreate( cName );
+    TEST_CHECK( xDispatcher != NULL );
+
+    /* Expiries reach the client. */
+    xPid = fork();
+    TEST_CHECK( xPid >= 0 );
+
+    if( xPid == 0 ) {
+        prvChildReceive();
+    }
+
+    prvWaitChild( xPid, pdTRUE );
+
+    /* A client that dies holding every timer and one of the two client
+     * slots. */
+    xPid = prvForkWithPipes( prvChildAbandon, &iGo );
+    TEST_CHECK( xTimerGetExpectedIdleTime() != portMAX_DELAY );
+    xClient = xSharedTimerClientAttach( cName );
+    TEST_CHECK( xClient != NULL );
+    TEST_CHECK( xSharedTimerClientAttach( cName ) == NULL );
+    TEST_CHECK( xSharedTimerCreate( xClient, 1U, pdFALSE, 0U ) == tmrINVALID_TIMER_REF );
+
+    /* Reaped (a zombie still answers kill()) by a later pass once
+     * portSHARED_TIMER_REAP_MS has passed. */
+    ( void ) close( iGo );
+    prvWaitChild( xPid, pdFALSE );
+
+    for( ulPasses = 0U; xTimerGetExpectedIdleTime() != portMAX_DELAY; ulPasses++ ) {
+        TEST_CHECK( ulPasses < 5000U );
+        prvDispatch();
+    }
+
+    xSecond = xSharedTimerClientAttach( cName );
+    TEST_CHECK( xSecond != NULL );
+
+    for( x = 0U; x < ( uint32_t ) portSHARED_TIMER_COUNT; x++ ) {
+        TEST_CHECK( xSharedTimerCreate( xClient, 1U, pdFALSE, 0U ) != tmrINVALID_TIMER_REF );
+    }
+
+    vSharedTimerClientDetach( xSecond );
+    vSharedTimerClientDetach( xClient );
+
+    while( uxSharedTimerServiceProcess( xDispatcher ) != 0U ) {
+    }
+
+    /* A client writes over the segment while one of its timers runs.  The
+     * dispatcher's own timers must keep firing on time. */
+    xLocal = xTimerCreate( "local", 7U, pdTRUE, NULL, prvLocalCallback );
+    TEST_CHECK( ( xLocal != NULL ) && ( xTimerStart( xLocal, 0 ) == pdTRUE ) );
+    xPid = prvForkWithPipes( prvChildScribble, &iGo );
+    ( void ) close( iGo );
+    prvWaitChild( xPid, pdFALSE );
+    ulLocalFired = 0U;
+
+    for( ulPasses = 0U; ulPasses < 700U; ulPasses++ ) {
+        prvDispatch();
+    }
+
+    TEST_CHECK( ulLocalFired == 100U );
+    TEST_CHECK( xTimerDelete( xLocal, 0 ) == pdTRUE );
+    vSharedTimerServiceDelete( xDispatcher );
+    TEST_CHECK( xTimerGetExpectedIdleTime() == portMAX_DELAY );
+
+    printf( "test_shared: ok\n" );
+    return 0;
+}
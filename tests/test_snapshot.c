@@ -0,0 +1,167 @@
+/*
+ * test_snapshot.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Save and restore a snapshot taken just before the tick count wraps, with
+ *  timers in the overflow list and timers that are overdue because the task
+ *  has not run yet.  The members of a period group are saved as timers of
+ *  their own, the group is not, and timers held back by a class budget are
+ *  saved as due now.
+ */
+
+#include <string.h>
+
+#include "test_util.h"
+
+#define TEST_TIMERS    6
+#define TEST_MEMBERS   5
+#define TEST_KEYS      ( TEST_TIMERS + TEST_MEMBERS )
+#define TEST_START     ( ( uint32_t ) 0xfffffff0UL )
+#define TEST_SAVE      ( ( uint32_t ) 0xfffffffcUL )
+
+static const TickType_t xPeriods[ TEST_TIMERS ] = { 5U, 8U, 30U, 20U, 40U, 7U };
+static uint32_t ulCallTicks[ TEST_KEYS ];
+static uint8_t ucBuffer[ 1024 ];
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    ulCallTicks[ ( uintptr_t ) pvTimerGetTimerID( xTimer ) ] = ulTestTick;
+}
+
+static BaseType_t prvGetKey( TimerHandle_t xTimer,
+                             uint64_t * pullKey )
+{
+    *pullKey = ( uint64_t ) ( uintptr_t ) pvTimerGetTimerID( xTimer );
+
+    /* Never asked for the group, whose ID is not one of ours. */
+    TEST_CHECK( *pullKey < TEST_KEYS );
+    return pdTRUE;
+}
+
+static TimerHandle_t prvCreate( uint64_t ullKey,
+                                TickType_t xPeriod,
+                                UBaseType_t uxAutoReload,
+                                void * pvContext )
+{
+    ( void ) pvContext;
+    return xTimerCreate( "restored", xPeriod, uxAutoReload, ( void * ) ( uintptr_t ) ullKey, prvCallback );
+}
+
+int main( void )
+{
+    const TimerSnapshotHeader_t * pxHeader = ( const TimerSnapshotHeader_t * ) ucBuffer;
+    const TimerSnapshotRecord_t * pxRecords = ( const TimerSnapshotRecord_t * ) ( pxHeader + 1 );
+    PeriodGroupHandle_t xGroup;
+    size_t xSize;
+    uint32_t ul;
+    uintptr_t x;
+
+    ulTestTick = TEST_START;
+    dk_soft_timer_init( &prvTestGetTick );
+
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        xTimerStart( xTimerCreate( "saved", xPeriods[ x ], pdFALSE, ( void * ) x, prvCallback ), 0 );
+    }
+
+    /* Timers 0, 1 and 5 are overdue, 2, 3 and 4 wait in the overflow list. */
+    ulTestTick = TEST_SAVE;
+    xSize = xTimerSnapshotSave( ucBuffer, sizeof( ucBuffer ), 1000U, prvGetKey );
+    TEST_CHECK( xSize == ( sizeof( TimerSnapshotHeader_t ) + ( TEST_TIMERS * sizeof( TimerSnapshotRecord_t ) ) ) );
+    TEST_CHECK( ( pxHeader->usFlags & tmrSNAPSHOT_FLAG_SORTED ) != 0U );
+
+    for( ul = 0; ul < pxHeader->ulCount; ul++ ) {
+        const uintptr_t xKey = ( uintptr_t ) pxRecords[ ul ].ullKey;
+        const uint32_t ulDue = TEST_START + xPeriods[ xKey ];
+
+        if( ( int32_t ) ( ulDue - TEST_SAVE ) <= 0 ) {
+            TEST_CHECK( pxRecords[ ul ].ulExpiry == 0U );
+        }
+        else {
+            TEST_CHECK( pxRecords[ ul ].ulExpiry == ( uint32_t ) ( ulDue - TEST_SAVE ) );
+        }
+
+        if( ul > 0U ) {
+            TEST_CHECK( pxRecords[ ul ].ulExpiry >= pxRecords[ ul - 1U ].ulExpiry );
+        }
+    }
+
+    /* Restart with the clock elsewhere, 2 ticks after the anchor. */
+    ulTestTick = 500U;
+    dk_soft_timer_init( &prvTestGetTick );
+    memset( ulCallTicks, 0, sizeof( ulCallTicks ) );
+    TEST_CHECK( uxTimerSnapshotLoad( ucBuffer, xSize, 1002U, prvCreate, NULL ) == TEST_TIMERS );
+
+    for( ul = 500U; ul <= 560U; ul++ ) {
+        vTestRunAt( ul );
+    }
+
+    /* Overdue timers expire at once, the others as much later as they had
+     * left when saved, less the 2 ticks that passed before the restart. */
+    for( x = 0; x < TEST_TIMERS; x++ ) {
+        const int32_t lRemaining = ( int32_t ) ( uint32_t ) ( TEST_START + xPeriods[ x ] - TEST_SAVE ) - 2;
+
+        TEST_CHECK( ulCallTicks[ x ] == ( 500U + ( uint32_t ) ( ( lRemaining > 0 ) ? lRemaining : 0 ) ) );
+    }
+
+    /* A group with a period of 50 started at 1000, saved at 1020 with the
+     * last member one-shot. */
+    ulTestTick = 1000U;
+    dk_soft_timer_init( &prvTestGetTick );
+    xGroup = xTimerPeriodGroupCreate( "group", 50U );
+    TEST_CHECK( xGroup != NULL );
+
+    for( x = TEST_TIMERS; x < TEST_KEYS; x++ ) {
+        TEST_CHECK( xTimerPeriodGroupAdd( xGroup, xTimerCreate( "member", 1U, ( x + 1U < TEST_KEYS ) ? pdTRUE : pdFALSE, ( void * ) x, prvCallback ) ) == pdTRUE );
+    }
+
+    ulTestTick = 1020U;
+    xSize = xTimerSnapshotSave( ucBuffer, sizeof( ucBuffer ), 3000U, prvGetKey );
+    TEST_CHECK( xSize == ( sizeof( TimerSnapshotHeader_t ) + ( TEST_MEMBERS * sizeof( TimerSnapshotRecord_t ) ) ) );
+
+    for( ul = 0; ul < pxHeader->ulCount; ul++ ) {
+        TEST_CHECK( pxRecords[ ul ].ullKey >= TEST_TIMERS );
+        TEST_CHECK( pxRecords[ ul ].ulExpiry == 30U );
+        TEST_CHECK( pxRecords[ ul ].ulPeriod == 50U );
+        TEST_CHECK( pxRecords[ ul ].ulFlags == ( ( pxRecords[ ul ].ullKey + 1U < TEST_KEYS ) ? tmrSNAPSHOT_AUTORELOAD : 0U ) );
+    }
+
+    ulTestTick = 0U;
+    dk_soft_timer_init( &prvTestGetTick );
+    memset( ulCallTicks, 0, sizeof( ulCallTicks ) );
+    TEST_CHECK( uxTimerSnapshotLoad( ucBuffer, xSize, 3000U, prvCreate, NULL ) == TEST_MEMBERS );
+
+    for( ul = 1U; ul <= 40U; ul++ ) {
+        vTestRunAt( ul );
+    }
+
+    for( x = TEST_TIMERS; x < TEST_KEYS; x++ ) {
+        TEST_CHECK( ulCallTicks[ x ] == 30U );
+    }
+
+    /* Three timers due at 10 with a budget of one callback per pass: the
+     * two left waiting are saved as due now, the one called is not saved. */
+    ulTestTick = 0U;
+    dk_soft_timer_init( &prvTestGetTick );
+    vTimerSetClassBudget( 0U, 1U );
+
+    for( x = 0; x < 3U; x++ ) {
+        xTimerStart( xTimerCreate( "held", 10U, pdFALSE, ( void * ) x, prvCallback ), 0 );
+    }
+
+    xTimerStart( xTimerCreate( "later", 25U, pdFALSE, ( void * ) 3U, prvCallback ), 0 );
+
+    ulTestTick = 10U;
+    dk_timer_task();
+    xSize = xTimerSnapshotSave( ucBuffer, sizeof( ucBuffer ), 0U, prvGetKey );
+    TEST_CHECK( xSize == ( sizeof( TimerSnapshotHeader_t ) + ( 3U * sizeof( TimerSnapshotRecord_t ) ) ) );
+    TEST_CHECK( ( pxHeader->usFlags & tmrSNAPSHOT_FLAG_SORTED ) != 0U );
+    TEST_CHECK( ( pxRecords[ 0 ].ulExpiry == 0U ) && ( pxRecords[ 0 ].ullKey < 3U ) );
+    TEST_CHECK( ( pxRecords[ 1 ].ulExpiry == 0U ) && ( pxRecords[ 1 ].ullKey < 3U ) );
+    TEST_CHECK( ( pxRecords[ 2 ].ulExpiry == 15U ) && ( pxRecords[ 2 ].ullKey == 3U ) );
+    vTimerSetClassBudget( 0U, 0U );
+
+    printf( "test_snapshot: ok\n" );
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * test_util.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Fake tick source and check macro shared by the host tests.  The tick is
+ *  only ever moved by the test, so every dk_timer_task() pass sees exactly
+ *  the time the test set.
+ */
+
+#ifndef TEST_UTIL_H_
+#define TEST_UTIL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dk_soft_timer.h"
+
+static uint32_t ulTestTick = 0;
+
+static inline uint32_t prvTestGetTick( void )
+{
+    return ulTestTick;
+}
+
+/* Sets the clock and runs the timer task until it has nothing more to do
+ * at that tick.  Bounded, a pass may legitimately leave work behind. */
+static inline void vTestRunAt( uint32_t ulTick )
+{
+    int i;
+
+    ulTestTick = ulTick;
+
+    for( i = 0; i < 64; i++ )
+    {
+        dk_timer_task();
+
+        if( xTimerGetExpectedIdleTime() != 0U )
+        {
+            break;
+        }
+    }
+}
+
+#define TEST_CHECK( xCondition )                                           \
+    do {                                                                   \
+        if( !( xCondition ) )                                              \
+        {                                                                  \
+            printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #xCondition ); \
+            exit( 1 );                                                     \
+        }                                                                  \
+    } while( 0 )
+
+#endif /* TEST_UTIL_H_ */
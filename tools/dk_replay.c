@@ -0,0 +1,356 @@
+/*
+ * dk_replay.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Host tool that replays a workload recorded with vTimerWorkloadRecordStart()
+ *  on a virtual clock, against whatever backend the soft timer is built with.
+ *
+ *      cc -O2 -I.. [options] -o dk_replay dk_replay.c ../dk_soft_timer.c ../list.c
+ *      dk_replay [-o order.txt] recording.bin
+ *
+ *  The clock is set to the tick of each record before it is applied, and
+ *  dk_timer_task() is run once for every pass in which the recorded task
+ *  found work, so the replay expires the same timers at the same ticks as
+ *  long as the backends agree on the order of equal expiry times.  Prints the
+ *  replay time, the peak number of timers and the process peak RSS, and
+ *  checks the order in which timers expired against the recording.  -o
+ *  writes that order, one "tick timer" line per expiry, so the runs of two
+ *  builds can be compared with diff.
+ *
+ *  Starts are replayed at the tick they were applied, so a FromISR start
+ *  whose command time is older than that tick expires later than it did when
+ *  it was recorded, and a recording made with a batch callback installed
+ *  replays one expiry per pass.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "dk_soft_timer.h"
+#include "dk_timer_workload.h"
+
+/* Maps the recorded timer identifiers to the replayed timers.  Open
+ * addressing, cleared entries keep xTimer NULL and ulId non-zero so probing
+ * continues past them. */
+typedef struct xREPLAY_ENTRY
+{
+    uint32_t ulId;
+    uint32_t ulUsed;
+    TimerHandle_t xTimer;
+} ReplayEntry_t;
+
+static ReplayEntry_t * pxMap;
+static size_t xMapCapacity;
+static size_t xMapUsed;
+
+static uint32_t ulNow;
+
+/* Expiry order, of the recording and of the replay. */
+static uint32_t * pulRecorded;
+static size_t xRecordedCount;
+static uint32_t * pulReplayed;
+static uint32_t * pulReplayedTicks;
+static size_t xReplayedCount;
+static size_t xExpiryCapacity;
+
+static uint32_t prvGetTicks( void )
+{
+    return ulNow;
+}
+
+static size_t prvHash( uint32_t ulId )
+{
+    return ( size_t ) ( ( ulId * 2654435761UL ) & 0xffffffffUL );
+}
+
+static ReplayEntry_t * prvFind( uint32_t ulId )
+{
+    size_t x = prvHash( ulId ) & ( xMapCapacity - 1U );
+
+    if( xMapCapacity == 0U ) {
+        return NULL;
+    }
+
+    while( pxMap[ x ].ulUsed != 0U ) {
+        if( ( pxMap[ x ].ulId == ulId ) && ( pxMap[ x ].xTimer != NULL ) ) {
+            return &( pxMap[ x ] );
+        }
+
+        x = ( x + 1U ) & ( xMapCapacity - 1U );
+    }
+
+    return NULL;
+}
+
+static void prvInsert( uint32_t ulId,
+                       TimerHandle_t xTimer )
+{
+    ReplayEntry_t * pxOld = pxMap;
+    size_t xOldCapacity = xMapCapacity;
+    size_t x;
+
+    /* Cleared entries count as used, rebuild once they fill half the map. */
+    if( ( ( xMapUsed + 1U ) * 2U ) > xMapCapacity ) {
+        xMapCapacity = ( xMapCapacity == 0U ) ? 1024U : ( xMapCapacity * 2U );
+        pxMap = ( ReplayEntry_t * ) calloc( xMapCapacity, sizeof( ReplayEntry_t ) );
+
+        if( pxMap == NULL ) {
+            fprintf( stderr, "out of memory\n" );
+            exit( 1 );
+        }
+
+        xMapUsed = 0U;
+
+        for( x = 0U; x < xOldCapacity; x++ ) {
+            if( pxOld[ x ].xTimer != NULL ) {
+                prvInsert( pxOld[ x ].ulId, pxOld[ x ].xTimer );
+            }
+        }
+
+        free( pxOld );
+    }
+
+    x = prvHash( ulId ) & ( xMapCapacity - 1U );
+
+    while( pxMap[ x ].ulUsed != 0U ) {
+        x = ( x + 1U ) & ( xMapCapacity - 1U );
+    }
+
+    pxMap[ x ].ulId = ulId;
+    pxMap[ x ].ulUsed = 1U;
+    pxMap[ x ].xTimer = xTimer;
+    xMapUsed++;
+}
+
+static void prvAppend( uint32_t ** ppulArray,
+                       size_t xCount,
+                       uint32_t ulValue )
+{
+    if( xCount == xExpiryCapacity ) {
+        /* All three arrays share the capacity and grow together. */
+        size_t xNewCapacity = ( xExpiryCapacity == 0U ) ? 4096U : ( xExpiryCapacity * 2U );
+
+        pulRecorded = ( uint32_t * ) realloc( pulRecorded, xNewCapacity * sizeof( uint32_t ) );
+        pulReplayed = ( uint32_t * ) realloc( pulReplayed, xNewCapacity * sizeof( uint32_t ) );
+        pulReplayedTicks = ( uint32_t * ) realloc( pulReplayedTicks, xNewCapacity * sizeof( uint32_t ) );
+
+        if( ( pulRecorded == NULL ) || ( pulReplayed == NULL ) || ( pulReplayedTicks == NULL ) ) {
+            fprintf( stderr, "out of memory\n" );
+            exit( 1 );
+        }
+
+        xExpiryCapacity = xNewCapacity;
+    }
+
+    ( *ppulArray )[ xCount ] = ulValue;
+}
+
+static void prvExpired( TimerHandle_t xTimer )
+{
+    prvAppend( &pulReplayedTicks, xReplayedCount, ulNow );
+    prvAppend( &pulReplayed, xReplayedCount, ( uint32_t ) ( uintptr_t ) pvTimerGetTimerID( xTimer ) );
+    xReplayedCount++;
+}
+
+int main( int argc, char ** argv )
+{
+    TimerWorkloadHeader_t xHeader;
+    TimerWorkloadRecord_t * pxRecords;
+    TimerWorkloadRecord_t * pxRecord;
+    ReplayEntry_t * pxEntry;
+    TimerHandle_t xTimer;
+    const char * pcOrderPath = NULL;
+    const char * pcPath;
+    struct timespec xStart;
+    struct timespec xEnd;
+    struct rusage xUsage;
+    unsigned long ulCalls = 0UL;
+    unsigned long ulFailed = 0UL;
+    size_t xLive = 0U;
+    size_t xPeakLive = 0U;
+    size_t xRecordCount;
+    size_t xFirstDifference;
+    long lFileSize;
+    double dSeconds;
+    FILE * pxFile;
+    size_t x;
+
+    if( ( argc == 4 ) && ( strcmp( argv[ 1 ], "-o" ) == 0 ) ) {
+        pcOrderPath = argv[ 2 ];
+    }
+    else if( argc != 2 ) {
+        fprintf( stderr, "usage: %s [-o order.txt] recording.bin\n", argv[ 0 ] );
+        return 2;
+    }
+
+    pcPath = argv[ argc - 1 ];
+    pxFile = fopen( pcPath, "rb" );
+
+    if( pxFile == NULL ) {
+        perror( pcPath );
+        return 1;
+    }
+
+    if( ( fread( &xHeader, sizeof( xHeader ), 1, pxFile ) != 1 ) ||
+        ( xHeader.ulMagic != tmrWORKLOAD_MAGIC ) ||
+        ( xHeader.usVersion != tmrWORKLOAD_VERSION ) ||
+        ( xHeader.usRecordSize != sizeof( TimerWorkloadRecord_t ) ) ) {
+        fprintf( stderr, "%s: not a timer workload recording\n", pcPath );
+        fclose( pxFile );
+        return 1;
+    }
+
+    /* Load everything first so file I/O is not part of the timing. */
+    ( void ) fseek( pxFile, 0L, SEEK_END );
+    lFileSize = ftell( pxFile );
+    ( void ) fseek( pxFile, ( long ) sizeof( xHeader ), SEEK_SET );
+    xRecordCount = ( size_t ) ( lFileSize - ( long ) sizeof( xHeader ) ) / sizeof( TimerWorkloadRecord_t );
+    pxRecords = ( TimerWorkloadRecord_t * ) malloc( ( xRecordCount + 1U ) * sizeof( TimerWorkloadRecord_t ) );
+
+    if( ( pxRecords == NULL ) || ( fread( pxRecords, sizeof( TimerWorkloadRecord_t ), xRecordCount, pxFile ) != xRecordCount ) ) {
+        fprintf( stderr, "%s: cannot read %lu records\n", pcPath, ( unsigned long ) xRecordCount );
+        fclose( pxFile );
+        return 1;
+    }
+
+    fclose( pxFile );
+
+    ulNow = ( xRecordCount != 0U ) ? pxRecords[ 0 ].ulTick : 0U;
+    dk_soft_timer_init( prvGetTicks );
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xStart );
+
+    for( x = 0U; x < xRecordCount; x++ ) {
+        pxRecord = &( pxRecords[ x ] );
+        ulNow = pxRecord->ulTick;
+
+        if( pxRecord->ucOp == tmrWORKLOAD_OP_EXPIRED ) {
+            /* Timers created before the recording started are not replayed. */
+            if( prvFind( pxRecord->ulTimer ) != NULL ) {
+                prvAppend( &pulRecorded, xRecordedCount, pxRecord->ulTimer );
+                xRecordedCount++;
+            }
+
+            continue;
+        }
+
+        if( pxRecord->ucOp == tmrWORKLOAD_OP_TASK ) {
+            /* A pass spent on a timer created before the recording started
+             * would expire one of ours too early. */
+            if( ( ( x + 1U ) < xRecordCount ) &&
+                ( pxRecords[ x + 1U ].ucOp == tmrWORKLOAD_OP_EXPIRED ) &&
+                ( prvFind( pxRecords[ x + 1U ].ulTimer ) == NULL ) ) {
+                continue;
+            }
+
+            dk_timer_task();
+            ulCalls++;
+            continue;
+        }
+
+        pxEntry = prvFind( pxRecord->ulTimer );
+
+        if( pxRecord->ucOp == tmrWORKLOAD_OP_CREATE ) {
+            if( pxEntry != NULL ) {
+                /* Freed without a delete being recorded. */
+                ( void ) xTimerDelete( pxEntry->xTimer, 0 );
+                pxEntry->xTimer = NULL;
+                xLive--;
+            }
+
+            xTimer = xTimerCreate( "replay", pxRecord->ulValue,
+                                   ( ( pxRecord->ucFlags & tmrWORKLOAD_FLAG_AUTORELOAD ) != 0U ) ? pdTRUE : pdFALSE,
+                                   ( void * ) ( uintptr_t ) pxRecord->ulTimer, prvExpired );
+            ulCalls++;
+
+            if( xTimer == NULL ) {
+                ulFailed++;
+                continue;
+            }
+
+            prvInsert( pxRecord->ulTimer, xTimer );
+
+            if( ++xLive > xPeakLive ) {
+                xPeakLive = xLive;
+            }
+
+            continue;
+        }
+
+        if( pxEntry == NULL ) {
+            /* Created before the recording started. */
+            continue;
+        }
+
+        ulCalls++;
+
+        switch( pxRecord->ucOp ) {
+            case tmrWORKLOAD_OP_START:
+                ( void ) xTimerStart( pxEntry->xTimer, 0 );
+                break;
+
+            case tmrWORKLOAD_OP_STOP:
+                ( void ) xTimerStop( pxEntry->xTimer, 0 );
+                break;
+
+            case tmrWORKLOAD_OP_CHANGE_PERIOD:
+                ( void ) xTimerChangePeriod( pxEntry->xTimer, pxRecord->ulValue, 0 );
+                break;
+
+            case tmrWORKLOAD_OP_DELETE:
+                ( void ) xTimerDelete( pxEntry->xTimer, 0 );
+                pxEntry->xTimer = NULL;
+                xLive--;
+                break;
+
+            default:
+                ulCalls--;
+                break;
+        }
+    }
+
+    ( void ) clock_gettime( CLOCK_MONOTONIC, &xEnd );
+    dSeconds = ( double ) ( xEnd.tv_sec - xStart.tv_sec ) + ( ( double ) ( xEnd.tv_nsec - xStart.tv_nsec ) / 1e9 );
+    ( void ) getrusage( RUSAGE_SELF, &xUsage );
+
+    for( xFirstDifference = 0U; xFirstDifference < xRecordedCount; xFirstDifference++ ) {
+        if( ( xFirstDifference == xReplayedCount ) || ( pulRecorded[ xFirstDifference ] != pulReplayed[ xFirstDifference ] ) ) {
+            break;
+        }
+    }
+
+    printf( "records      %lu\n", ( unsigned long ) xRecordCount );
+    printf( "calls        %lu in %.3f ms, %.0f calls/s\n", ulCalls, dSeconds * 1e3, ( dSeconds > 0.0 ) ? ( ( double ) ulCalls / dSeconds ) : 0.0 );
+    printf( "timers       %lu peak, %lu bytes each, %lu creates failed\n", ( unsigned long ) xPeakLive, ( unsigned long ) sizeof( StaticTimer_t ), ulFailed );
+    printf( "peak rss     %ld KiB\n", xUsage.ru_maxrss );
+    printf( "expiries     %lu replayed, %lu recorded\n", ( unsigned long ) xReplayedCount, ( unsigned long ) xRecordedCount );
+
+    if( ( xFirstDifference == xRecordedCount ) && ( xReplayedCount == xRecordedCount ) ) {
+        printf( "order        identical\n" );
+    }
+    else {
+        printf( "order        differs from expiry %lu\n", ( unsigned long ) xFirstDifference );
+    }
+
+    if( pcOrderPath != NULL ) {
+        pxFile = fopen( pcOrderPath, "w" );
+
+        if( pxFile == NULL ) {
+            perror( pcOrderPath );
+            return 1;
+        }
+
+        for( x = 0U; x < xReplayedCount; x++ ) {
+            fprintf( pxFile, "%lu 0x%08lx\n", ( unsigned long ) pulReplayedTicks[ x ], ( unsigned long ) pulReplayed[ x ] );
+        }
+
+        fclose( pxFile );
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * dk_trace_decode.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: lochy
+ *
+ *  Host tool that decodes a dump produced by uxTimerTraceDump().
+ *
+ *      cc -I.. -o dk_trace_decode dk_trace_decode.c
+ *      dk_trace_decode [-c] dump.bin
+ *
+ *  Prints one line per record, or CSV with -c.  The dump must come from a
+ *  target with the same byte order as the host.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dk_timer_trace.h"
+
+static const char * prvEventName( uint16_t usEvent )
+{
+    switch( usEvent ) {
+        case tmrTRACE_EVENT_START:
+            return "start";
+
+        case tmrTRACE_EVENT_STOP:
+            return "stop";
+
+        case tmrTRACE_EVENT_CHANGE_PERIOD:
+            return "change_period";
+
+        case tmrTRACE_EVENT_EXPIRED:
+            return "expired";
+
+        case tmrTRACE_EVENT_CALLBACK:
+            return "callback";
+
+        default:
+            return "unknown";
+    }
+}
+
+int main( int argc, char ** argv )
+{
+    TimerTraceHeader_t xHeader;
+    TimerTraceRecord_t xRecord;
+    uint32_t ulPreviousTimestamp = 0U;
+    uint16_t usExpectedSequence = 0U;
+    int iCsv = 0;
+    uint32_t ul;
+    FILE * pxFile;
+
+    if( ( argc == 3 ) && ( strcmp( argv[ 1 ], "-c" ) == 0 ) ) {
+        iCsv = 1;
+    }
+    else if( argc != 2 ) {
+        fprintf( stderr, "usage: %s [-c] dump.bin\n", argv[ 0 ] );
+        return 2;
+    }
+
+    pxFile = fopen( argv[ argc - 1 ], "rb" );
+
+    if( pxFile == NULL ) {
+        perror( argv[ argc - 1 ] );
+        return 1;
+    }
+
+    if( ( fread( &xHeader, sizeof( xHeader ), 1, pxFile ) != 1 ) ||
+        ( xHeader.ulMagic != tmrTRACE_MAGIC ) ||
+        ( xHeader.usVersion != tmrTRACE_VERSION ) ||
+        ( xHeader.usRecordSize != sizeof( TimerTraceRecord_t ) ) ) {
+        fprintf( stderr, "%s: not a timer trace dump\n", argv[ argc - 1 ] );
+        fclose( pxFile );
+        return 1;
+    }
+
+    if( iCsv != 0 ) {
+        printf( "sequence,timestamp,delta,event,timer,value\n" );
+    }
+    else {
+        printf( "# %lu records, %lu overwritten\n", ( unsigned long ) xHeader.ulCount, ( unsigned long ) xHeader.ulOverwritten );
+    }
+
+    for( ul = 0; ul < xHeader.ulCount; ul++ ) {
+        if( fread( &xRecord, sizeof( xRecord ), 1, pxFile ) != 1 ) {
+            fprintf( stderr, "%s: truncated after %lu records\n", argv[ argc - 1 ], ( unsigned long ) ul );
+            fclose( pxFile );
+            return 1;
+        }
+
+        if( iCsv != 0 ) {
+            printf( "%u,%lu,%lu,%s,0x%08lx,%lu\n",
+                    ( unsigned ) xRecord.usSequence,
+                    ( unsigned long ) xRecord.ulTimestamp,
+                    ( unsigned long ) ( ( ul == 0U ) ? 0U : ( xRecord.ulTimestamp - ulPreviousTimestamp ) ),
+                    prvEventName( xRecord.usEvent ),
+                    ( unsigned long ) xRecord.ulTimer,
+                    ( unsigned long ) xRecord.ulValue );
+        }
+        else {
+            if( ( ul != 0U ) && ( xRecord.usSequence != usExpectedSequence ) ) {
+                printf( "# gap: %u records overwritten during the dump\n", ( unsigned ) ( uint16_t ) ( xRecord.usSequence - usExpectedSequence ) );
+            }
+
+            printf( "%5u %10lu %+10ld %-14s timer=0x%08lx value=%lu\n",
+                    ( unsigned ) xRecord.usSequence,
+                    ( unsigned long ) xRecord.ulTimestamp,
+                    ( long ) ( ( ul == 0U ) ? 0 : ( int32_t ) ( xRecord.ulTimestamp - ulPreviousTimestamp ) ),
+                    prvEventName( xRecord.usEvent ),
+                    ( unsigned long ) xRecord.ulTimer,
+                    ( unsigned long ) xRecord.ulValue );
+        }
+
+        ulPreviousTimestamp = xRecord.ulTimestamp;
+        usExpectedSequence = ( uint16_t ) ( xRecord.usSequence + 1U );
+    }
+
+    fclose( pxFile );
+
+    return 0;
+}